@@ -6,12 +6,30 @@
  */
 
 // VecMem include(s).
+#include <vecmem/memory/arena_memory_resource.hpp>
 #include <vecmem/memory/binary_page_memory_resource.hpp>
+#include <vecmem/memory/caching_memory_resource.hpp>
+#include <vecmem/memory/coalescing_memory_resource.hpp>
+#include <vecmem/memory/contiguous_memory_resource.hpp>
+#include <vecmem/memory/debug_memory_resource.hpp>
+#include <vecmem/memory/frame_memory_resource.hpp>
 #include <vecmem/memory/host_memory_resource.hpp>
+#include <vecmem/memory/instrumenting_memory_resource.hpp>
+#include <vecmem/memory/mmap_memory_resource.hpp>
+#include <vecmem/memory/thread_caching_memory_resource.hpp>
+#include <vecmem/utils/memory_monitor.hpp>
 
 // Google benchmark include(s).
 #include <benchmark/benchmark.h>
 
+// System include(s).
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
 /// The (host) memory resource to use in the benchmark(s)
 static vecmem::host_memory_resource host_mr;
 
@@ -24,6 +42,59 @@ void BenchmarkHost(benchmark::State& state) {
 
 BENCHMARK(BenchmarkHost)->RangeMultiplier(2)->Range(1, 2UL << 31);
 
+void BenchmarkHostRandomAccess(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+    const bool huge_pages = (state.range(1) != 0);
+
+    // Allocate and initialise a large buffer, backed by huge pages or not.
+    vecmem::host_memory_resource mr(
+        huge_pages ? vecmem::host_memory_resource::huge_page_size : 0);
+    char* buffer = static_cast<char*>(mr.allocate(size));
+    std::fill(buffer, buffer + size, 0);
+
+    // Measure the speed of accessing the buffer at random positions, which
+    // is dominated by TLB misses for large buffers.
+    std::default_random_engine eng;
+    eng.seed(size);
+    std::uniform_int_distribution<std::size_t> gen(0, size - 1);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < 1024; ++i) {
+            ++buffer[gen(eng)];
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+    benchmark::DoNotOptimize(buffer);
+
+    mr.deallocate(buffer, size);
+}
+
+BENCHMARK(BenchmarkHostRandomAccess)
+    ->ArgsProduct({benchmark::CreateRange(1UL << 24, 1UL << 28, 4), {0, 1}});
+
+void BenchmarkMmapFirstTouch(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+
+    // Map memory with or without pre-faulting it.
+    vecmem::mmap_memory_resource mr(state.range(1) != 0);
+
+    // Measure the time it takes to fill freshly allocated memory, without the
+    // time it takes to allocate it.
+    for (auto _ : state) {
+        state.PauseTiming();
+        char* p = static_cast<char*>(mr.allocate(size));
+        state.ResumeTiming();
+        std::fill(p, p + size, 1);
+        benchmark::DoNotOptimize(p);
+        state.PauseTiming();
+        mr.deallocate(p, size);
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BenchmarkMmapFirstTouch)
+    ->ArgsProduct({benchmark::CreateRange(1UL << 20, 1UL << 26, 8), {0, 1}});
+
 void BenchmarkBinaryPage(benchmark::State& state) {
     std::size_t size = state.range(0);
 
@@ -36,3 +107,417 @@ void BenchmarkBinaryPage(benchmark::State& state) {
 }
 
 BENCHMARK(BenchmarkBinaryPage)->RangeMultiplier(2)->Range(1, 2UL << 31);
+
+void BenchmarkBinaryPageFragmented(benchmark::State& state) {
+    const std::size_t n_live = state.range(0);
+
+    vecmem::binary_page_memory_resource mr(host_mr);
+
+    // Generate the sizes of the long-lived allocations.
+    std::default_random_engine eng;
+    eng.seed(n_live);
+    std::uniform_int_distribution<std::size_t> gen(1, 65536);
+
+    // Fill the pool with live allocations, and free every other one of them,
+    // to leave the pool in a fragmented state.
+    std::vector<std::pair<void*, std::size_t>> live(n_live);
+    for (auto& a : live) {
+        a.second = gen(eng);
+        a.first = mr.allocate(a.second);
+    }
+    for (std::size_t i = 0; i < live.size(); i += 2) {
+        mr.deallocate(live[i].first, live[i].second);
+    }
+
+    // Measure the allocation/de-allocation speed in this fragmented pool.
+    for (auto _ : state) {
+        const std::size_t size = gen(eng);
+        void* p = mr.allocate(size);
+        mr.deallocate(p, size);
+    }
+
+    // Clean up.
+    for (std::size_t i = 1; i < live.size(); i += 2) {
+        mr.deallocate(live[i].first, live[i].second);
+    }
+}
+
+BENCHMARK(BenchmarkBinaryPageFragmented)->RangeMultiplier(4)->Range(16, 16384);
+
+void BenchmarkBinaryPageRandomFree(benchmark::State& state) {
+    const std::size_t n_allocs = state.range(0);
+
+    vecmem::binary_page_memory_resource mr(host_mr);
+
+    // Generate the sizes of the allocations, and the order in which they
+    // would be freed.
+    std::default_random_engine eng;
+    eng.seed(n_allocs);
+    std::uniform_int_distribution<std::size_t> gen(1, 1048576);
+    std::vector<std::size_t> sizes(n_allocs);
+    std::generate(sizes.begin(), sizes.end(),
+                  [&eng, &gen]() { return gen(eng); });
+    std::vector<std::size_t> order(n_allocs);
+    for (std::size_t i = 0; i < n_allocs; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), eng);
+
+    // Allocate everything up front, and then free it in a random order. With
+    // allocations this large the pool grows to many superpages.
+    std::vector<void*> ptrs(n_allocs);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n_allocs; ++i) {
+            ptrs[i] = mr.allocate(sizes[i]);
+        }
+        for (std::size_t i : order) {
+            mr.deallocate(ptrs[i], sizes[i]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n_allocs);
+}
+
+BENCHMARK(BenchmarkBinaryPageRandomFree)->RangeMultiplier(4)->Range(16, 4096);
+
+/// Non-thread-safe binary page memory resource, used behind a global lock
+static vecmem::binary_page_memory_resource locked_binary_mr(host_mr);
+/// The lock protecting @c locked_binary_mr
+static std::mutex locked_binary_mr_mutex;
+
+void BenchmarkBinaryPageLocked(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+
+    for (auto _ : state) {
+        void* p = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(locked_binary_mr_mutex);
+            p = locked_binary_mr.allocate(size);
+        }
+        benchmark::DoNotOptimize(p);
+        {
+            std::lock_guard<std::mutex> lock(locked_binary_mr_mutex);
+            locked_binary_mr.deallocate(p, size);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BenchmarkBinaryPageLocked)
+    ->Arg(1024)
+    ->Arg(65536)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+/// Thread-safe, sharded binary page memory resource
+static vecmem::binary_page_memory_resource sharded_binary_mr(host_mr, 16);
+
+void BenchmarkBinaryPageSharded(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+
+    for (auto _ : state) {
+        void* p = sharded_binary_mr.allocate(size);
+        benchmark::DoNotOptimize(p);
+        sharded_binary_mr.deallocate(p, size);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BenchmarkBinaryPageSharded)
+    ->Arg(1024)
+    ->Arg(65536)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+void BenchmarkArenaFragmented(benchmark::State& state) {
+    const std::size_t n_live = state.range(0);
+
+    vecmem::arena_memory_resource mr(host_mr, 1UL << 26, 1UL << 34);
+
+    // Generate the sizes of the long-lived, and of the measured allocations.
+    std::default_random_engine eng;
+    eng.seed(n_live);
+    std::uniform_int_distribution<std::size_t> live_gen(1, 1024);
+    std::uniform_int_distribution<std::size_t> gen(1025, 65536);
+
+    // Fill the arena with small live allocations, and free every other one of
+    // them, to leave many small free blocks in front of the large free block.
+    std::vector<std::pair<void*, std::size_t>> live(n_live);
+    for (auto& a : live) {
+        a.second = live_gen(eng);
+        a.first = mr.allocate(a.second);
+    }
+    for (std::size_t i = 0; i < live.size(); i += 2) {
+        mr.deallocate(live[i].first, live[i].second);
+    }
+
+    // Measure the speed of allocations that do not fit into any of the small
+    // free blocks.
+    for (auto _ : state) {
+        const std::size_t size = gen(eng);
+        void* p = mr.allocate(size);
+        benchmark::DoNotOptimize(p);
+        mr.deallocate(p, size);
+    }
+
+    // Clean up.
+    for (std::size_t i = 1; i < live.size(); i += 2) {
+        mr.deallocate(live[i].first, live[i].second);
+    }
+}
+
+BENCHMARK(BenchmarkArenaFragmented)->RangeMultiplier(4)->Range(16, 16384);
+
+/// Thread-safe arena memory resource, with a sub-arena for every thread
+static vecmem::arena_memory_resource multi_arena_mr(host_mr, 1UL << 26,
+                                                    1UL << 34, 16);
+
+void BenchmarkArenaMulti(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+
+    for (auto _ : state) {
+        void* p = multi_arena_mr.allocate(size);
+        benchmark::DoNotOptimize(p);
+        multi_arena_mr.deallocate(p, size);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BenchmarkArenaMulti)
+    ->Arg(1024)
+    ->Arg(65536)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+/// Non-thread-safe binary page memory resource, behind per-thread caches
+static vecmem::binary_page_memory_resource cached_binary_mr(host_mr);
+/// Thread-caching memory resource in front of @c cached_binary_mr
+static vecmem::thread_caching_memory_resource thread_caching_mr(
+    cached_binary_mr);
+
+void BenchmarkThreadCaching(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+
+    for (auto _ : state) {
+        void* p = thread_caching_mr.allocate(size);
+        benchmark::DoNotOptimize(p);
+        thread_caching_mr.deallocate(p, size);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BenchmarkThreadCaching)
+    ->Arg(64)
+    ->Arg(1024)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+void BenchmarkCachingEventLoop(benchmark::State& state) {
+    const std::size_t n_buffers = state.range(0);
+
+    vecmem::caching_memory_resource mr(host_mr);
+
+    // Generate the buffer sizes that every "event" allocates.
+    std::default_random_engine eng;
+    eng.seed(n_buffers);
+    std::uniform_int_distribution<std::size_t> gen(1, 1048576);
+    std::vector<std::size_t> sizes(n_buffers);
+    std::generate(sizes.begin(), sizes.end(),
+                  [&eng, &gen]() { return gen(eng); });
+
+    // Allocate, and then free, the same set of buffers in every iteration.
+    std::vector<void*> ptrs(n_buffers);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n_buffers; ++i) {
+            ptrs[i] = mr.allocate(sizes[i]);
+        }
+        for (std::size_t i = 0; i < n_buffers; ++i) {
+            mr.deallocate(ptrs[i], sizes[i]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n_buffers);
+}
+
+BENCHMARK(BenchmarkCachingEventLoop)->RangeMultiplier(4)->Range(4, 1024);
+
+void BenchmarkContiguousGrowableEventLoop(benchmark::State& state) {
+    const std::size_t n_buffers = state.range(0);
+
+    vecmem::contiguous_memory_resource mr(host_mr, 65536, 2);
+
+    // Generate the buffer sizes that every "event" allocates.
+    std::default_random_engine eng;
+    eng.seed(n_buffers);
+    std::uniform_int_distribution<std::size_t> gen(1, 1048576);
+    std::vector<std::size_t> sizes(n_buffers);
+    std::generate(sizes.begin(), sizes.end(),
+                  [&eng, &gen]() { return gen(eng); });
+
+    // Allocate the same set of buffers in every iteration, and reclaim all
+    // of them at once at the end of the iteration.
+    for (auto _ : state) {
+        for (std::size_t size : sizes) {
+            void* p = mr.allocate(size);
+            benchmark::DoNotOptimize(p);
+        }
+        mr.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n_buffers);
+}
+
+BENCHMARK(BenchmarkContiguousGrowableEventLoop)
+    ->RangeMultiplier(4)
+    ->Range(4, 1024);
+
+void BenchmarkFrameEventLoop(benchmark::State& state) {
+    const std::size_t n_buffers = state.range(0);
+
+    vecmem::frame_memory_resource mr(host_mr, 1UL << 26);
+
+    // Generate the buffer sizes that every "event" allocates.
+    std::default_random_engine eng;
+    eng.seed(n_buffers);
+    std::uniform_int_distribution<std::size_t> gen(1, 65536);
+    std::vector<std::size_t> sizes(n_buffers);
+    std::generate(sizes.begin(), sizes.end(),
+                  [&eng, &gen]() { return gen(eng); });
+
+    // Allocate the same set of buffers for every frame, freeing them
+    // individually as a user would, and rotating the frames at the end of
+    // every iteration.
+    std::vector<void*> ptrs(n_buffers);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n_buffers; ++i) {
+            ptrs[i] = mr.allocate(sizes[i]);
+        }
+        for (std::size_t i = 0; i < n_buffers; ++i) {
+            mr.deallocate(ptrs[i], sizes[i]);
+        }
+        mr.begin_frame();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n_buffers);
+}
+
+BENCHMARK(BenchmarkFrameEventLoop)->RangeMultiplier(4)->Range(4, 1024);
+
+void BenchmarkDebugLive(benchmark::State& state) {
+    const std::size_t n_live = state.range(0);
+
+    vecmem::debug_memory_resource mr(host_mr, state.range(1));
+
+    // Keep a large number of allocations alive during the measurement.
+    std::vector<void*> live(n_live);
+    for (void*& p : live) {
+        p = mr.allocate(64);
+    }
+
+    // Measure the speed of (checked) allocations and de-allocations.
+    for (auto _ : state) {
+        void* p = mr.allocate(64);
+        mr.deallocate(p, 64);
+    }
+
+    for (void* p : live) {
+        mr.deallocate(p, 64);
+    }
+}
+
+BENCHMARK(BenchmarkDebugLive)
+    ->ArgsProduct({benchmark::CreateRange(16, 65536, 16), {1, 64}});
+
+void BenchmarkCoalescingPools(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+
+    vecmem::binary_page_memory_resource small_mr(host_mr);
+    vecmem::arena_memory_resource large_mr(host_mr, 1UL << 26, 1UL << 30);
+    vecmem::coalescing_memory_resource mr({small_mr, large_mr});
+
+    // De-allocations are routed back to the pools by ownership.
+    for (auto _ : state) {
+        void* p = mr.allocate(size);
+        mr.deallocate(p, size);
+    }
+}
+
+BENCHMARK(BenchmarkCoalescingPools)->RangeMultiplier(8)->Range(8, 1UL << 20);
+
+void BenchmarkCoalescingFullPools(benchmark::State& state) {
+    const std::size_t n_full = state.range(0);
+
+    // Set up a number of pools that are full, in front of the host resource.
+    std::vector<std::unique_ptr<vecmem::contiguous_memory_resource>> pools;
+    std::vector<std::reference_wrapper<vecmem::memory_resource>> upstreams;
+    for (std::size_t i = 0; i < n_full; ++i) {
+        pools.push_back(
+            std::make_unique<vecmem::contiguous_memory_resource>(host_mr, 64));
+        static_cast<void>(pools.back()->allocate(64));
+        upstreams.push_back(*(pools.back()));
+    }
+    upstreams.push_back(host_mr);
+    vecmem::coalescing_memory_resource mr(std::move(upstreams));
+
+    for (auto _ : state) {
+        void* p = mr.allocate(1024);
+        mr.deallocate(p, 1024);
+    }
+}
+
+BENCHMARK(BenchmarkCoalescingFullPools)->DenseRange(0, 4);
+
+void BenchmarkInstrumenting(benchmark::State& state) {
+    using instrumenting = vecmem::instrumenting_memory_resource;
+    const auto mode = static_cast<instrumenting::recording>(state.range(0));
+    const auto clock = static_cast<instrumenting::timing>(state.range(1));
+
+    instrumenting mr(host_mr, mode, 1024, clock);
+
+    for (auto _ : state) {
+        void* p = mr.allocate(64);
+        mr.deallocate(p, 64);
+    }
+}
+
+BENCHMARK(BenchmarkInstrumenting)->ArgsProduct({{0, 1, 2}, {0, 1, 2}});
+
+/// Instrumented host memory resource, only collecting aggregate statistics
+static vecmem::instrumenting_memory_resource instrumented_host_mr(
+    host_mr, vecmem::instrumenting_memory_resource::recording::aggregate, 0,
+    vecmem::instrumenting_memory_resource::timing::none);
+/// Instrumented host memory resource, also timing the requests
+static vecmem::instrumenting_memory_resource timed_host_mr(
+    host_mr, vecmem::instrumenting_memory_resource::recording::aggregate, 0,
+    vecmem::instrumenting_memory_resource::timing::ticks);
+/// Instrumented host memory resource, with a memory monitor attached
+static vecmem::instrumenting_memory_resource monitored_host_mr(
+    host_mr, vecmem::instrumenting_memory_resource::recording::aggregate, 0,
+    vecmem::instrumenting_memory_resource::timing::ticks);
+static vecmem::memory_monitor host_monitor(monitored_host_mr);
+
+void BenchmarkInstrumentingConcurrent(benchmark::State& state) {
+    const std::size_t size = state.range(0);
+
+    // Compare the instrumented resources with their upstream.
+    vecmem::memory_resource* resources[] = {
+        &host_mr, &instrumented_host_mr, &timed_host_mr, &monitored_host_mr};
+    vecmem::memory_resource& mr = *(resources[state.range(1)]);
+
+    for (auto _ : state) {
+        void* p = mr.allocate(size);
+        benchmark::DoNotOptimize(p);
+        mr.deallocate(p, size);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BenchmarkInstrumentingConcurrent)
+    ->ArgsProduct({{64, 65536}, {0, 1, 2, 3}})
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
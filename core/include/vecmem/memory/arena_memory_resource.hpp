@@ -13,6 +13,7 @@
 #include "vecmem/vecmem_core_export.hpp"
 
 // System include(s).
+#include <cstddef>
 #include <memory>
 
 // Disable the warning(s) about inheriting from/using standard library types
@@ -27,7 +28,8 @@ namespace vecmem {
 // Forward declaration(s).
 namespace details {
 class arena;
-}
+class multi_arena;
+}  // namespace details
 
 /// Memory resource implementing an arena allocation scheme
 class VECMEM_CORE_EXPORT arena_memory_resource final
@@ -45,9 +47,55 @@ public:
     arena_memory_resource(memory_resource& upstream, std::size_t initial_size,
                           std::size_t maximum_size);
 
+    /// Construct a thread-safe memory resource on top of an upstream memory
+    /// resource
+    ///
+    /// Every thread allocates small blocks from one of @c n_arenas
+    /// sub-arenas, which get their memory from a global arena in large
+    /// superblocks. Large blocks are allocated from the global arena
+    /// directly. Blocks can be de-allocated by any thread, with blocks of
+    /// other threads' sub-arenas handed back to them without locking.
+    ///
+    /// @param[in] upstream The @c vecmem::memory_resource to use for "upstream"
+    ///                     memory allocations
+    /// @param[in] initial_size Initial memory memory allocation from
+    ///                         @c upstream
+    /// @param[in] maximum_size The maximal allowed allocation from @c upstream
+    /// @param[in] n_arenas The number of sub-arenas, ideally the number of
+    ///                     threads using the resource
+    ///
+    arena_memory_resource(memory_resource& upstream, std::size_t initial_size,
+                          std::size_t maximum_size, std::size_t n_arenas);
+
     /// Destructor
     ~arena_memory_resource();
 
+    /// Release entirely free superblocks to the upstream memory resource
+    ///
+    /// Memory is never given back to the upstream resource automatically by
+    /// default, so after a peak in memory usage this function can be used to
+    /// shrink the arena again.
+    ///
+    /// @param[in] max_retained_bytes The maximal amount of memory to keep in
+    ///                               entirely free superblocks
+    /// @return The number of bytes released to the upstream resource
+    ///
+    std::size_t release_unused(std::size_t max_retained_bytes = 0);
+
+    /// Release entirely free superblocks automatically
+    ///
+    /// Whenever a de-allocation leaves more than @c high_watermark bytes in
+    /// entirely free superblocks, free superblocks are released to the
+    /// upstream resource until at most @c low_watermark bytes remain in them.
+    ///
+    /// @param[in] high_watermark The amount of free memory triggering a
+    ///                           release
+    /// @param[in] low_watermark The amount of free memory to keep after a
+    ///                          release
+    ///
+    void set_release_watermarks(std::size_t high_watermark,
+                                std::size_t low_watermark);
+
 private:
     /// @name Function(s) implemented from @c vecmem::memory_resource
     /// @{
@@ -60,8 +108,13 @@ private:
 
     /// @}
 
+    /// Check whether a pointer is in one of the superblocks of the arena
+    virtual ownership do_owns(const void* p) const noexcept override;
+
     /// Object performing the heavy lifting for the memory resource
     std::unique_ptr<details::arena> m_arena;
+    /// Object performing the heavy lifting in thread-safe mode
+    std::unique_ptr<details::multi_arena> m_multi_arena;
 
 };  // class arena_memory_resource
 
@@ -13,6 +13,7 @@
 #include "vecmem/vecmem_core_export.hpp"
 
 // System include(s).
+#include <cstddef>
 #include <memory>
 
 // Disable the warning(s) about inheriting from/using standard library types
@@ -27,7 +28,8 @@ namespace vecmem {
 // Forward declaration(s).
 namespace details {
 struct binary_page_memory_resource_impl;
-}
+struct sharded_binary_page_memory_resource_impl;
+}  // namespace details
 
 /**
  * @brief A memory manager using power-of-two pages that can be split to
@@ -39,6 +41,12 @@ struct binary_page_memory_resource_impl;
  * blocks can then be split in half and allocated, split in half again. This
  * creates a binary tree of pages which can be either vacant, occupied, or
  * split.
+ *
+ * By default the memory resource is not thread-safe. A thread-safe instance
+ * can be created by specifying a number of shards for it, over which the
+ * large blocks are distributed. Each shard is protected by its own lock, and
+ * threads allocate from the shard assigned to them, so multiple threads can
+ * use the memory resource in parallel.
  */
 class VECMEM_CORE_EXPORT binary_page_memory_resource
     : public details::memory_resource_base {
@@ -49,16 +57,59 @@ public:
      */
     binary_page_memory_resource(memory_resource &);
 
+    /**
+     * @brief Initialize a thread-safe binary page memory manager depending
+     * on an upstream memory resource.
+     *
+     * @param[in] upstream The upstream memory resource to use. It is only
+     *                     ever accessed under a lock, so it does not need to
+     *                     be thread-safe itself.
+     * @param[in] n_shards The number of independently locked shards to use.
+     *                     Using about as many shards as there are threads
+     *                     allocating memory gives the best scaling.
+     */
+    binary_page_memory_resource(memory_resource &upstream,
+                                std::size_t n_shards);
+
     /**
      * @brief Deconstruct a binary page memory manager, freeing all
      * allocated blocks upstream.
      *
      * The destructor is explicitly implemented to not require clients of the
      * class to know how to destruct
-     * @c vecmem::details::binary_page_memory_resource_impl.
+     * @c vecmem::details::binary_page_memory_resource_impl and
+     * @c vecmem::details::sharded_binary_page_memory_resource_impl.
      */
     ~binary_page_memory_resource();
 
+    /**
+     * @brief Release fully vacant superpages to the upstream resource.
+     *
+     * Memory is never given back to the upstream resource automatically by
+     * default, so after a peak in memory usage this function can be used to
+     * shrink the memory resource again.
+     *
+     * @param[in] max_retained_bytes The maximal amount of memory to keep in
+     *                               fully vacant superpages
+     * @return The number of bytes released to the upstream resource
+     */
+    std::size_t release_unused(std::size_t max_retained_bytes = 0);
+
+    /**
+     * @brief Release vacant superpages automatically.
+     *
+     * Whenever a deallocation leaves more than @c high_watermark bytes in
+     * fully vacant superpages, vacant superpages are released to the
+     * upstream resource until at most @c low_watermark bytes remain in them.
+     *
+     * @param[in] high_watermark The amount of vacant memory triggering a
+     *                           release
+     * @param[in] low_watermark The amount of vacant memory to keep after a
+     *                          release
+     */
+    void set_release_watermarks(std::size_t high_watermark,
+                                std::size_t low_watermark);
+
 private:
     /// @name Functions implemented from @c vecmem::memory_resource
     /// @{
@@ -70,8 +121,14 @@ private:
 
     /// @}
 
+    /// Check whether a pointer is in one of the superpages of the resource
+    virtual ownership do_owns(const void *p) const noexcept override;
+
     /// Object implementing the memory resource's logic
     std::unique_ptr<details::binary_page_memory_resource_impl> m_impl;
+    /// Object implementing the memory resource's logic in thread-safe mode
+    std::unique_ptr<details::sharded_binary_page_memory_resource_impl>
+        m_sharded_impl;
 
 };  // class binary_page_memory_resource
 
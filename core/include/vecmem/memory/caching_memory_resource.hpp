@@ -0,0 +1,117 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/details/memory_resource_base.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <memory>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+// Forward declaration(s).
+namespace details {
+struct caching_memory_resource_impl;
+}
+
+/**
+ * @brief A memory resource caching freed blocks for re-use.
+ *
+ * This is a non-terminal memory resource, meant for applications that
+ * allocate the same set of buffer sizes over and over again (for instance
+ * once per event). Allocation sizes are rounded up to geometrically growing
+ * bin sizes, and blocks freed by the user are kept in a cache instead of
+ * being given back to the upstream resource. A later allocation request of
+ * the same bin (and alignment) re-uses a cached block without calling the
+ * upstream resource.
+ *
+ * The total size of the cached blocks is limited. Whenever the limit would be
+ * exceeded, the least recently freed blocks are given back to the upstream
+ * resource. Allocations larger than the largest bin are not cached at all.
+ *
+ * The memory resource does not access the memory that it manages, so it can
+ * be used with any (host, device, pinned, etc.) upstream memory resource. It
+ * is not thread-safe.
+ */
+class VECMEM_CORE_EXPORT caching_memory_resource final
+    : public details::memory_resource_base {
+
+public:
+    /**
+     * @brief Initialize a caching memory resource on top of an upstream
+     * memory resource.
+     *
+     * @param[in] upstream The upstream memory resource to use
+     * @param[in] max_cached_bytes The maximal total size of the cached blocks
+     * @param[in] bin_growth The factor between the sizes of consecutive bins
+     * @param[in] min_bin_size The size of the smallest bin
+     * @param[in] max_bin_size The largest allocation size to cache
+     */
+    caching_memory_resource(memory_resource& upstream,
+                            std::size_t max_cached_bytes = 1UL << 30,
+                            std::size_t bin_growth = 2,
+                            std::size_t min_bin_size = 256,
+                            std::size_t max_bin_size = 1UL << 30);
+
+    /**
+     * @brief Destructor, giving all cached blocks back to the upstream
+     * resource.
+     */
+    ~caching_memory_resource();
+
+    /**
+     * @brief Give cached blocks back to the upstream resource.
+     *
+     * The least recently freed blocks are given back first.
+     *
+     * @param[in] max_retained_bytes The maximal total size of the blocks to
+     *                               keep in the cache
+     * @return The number of bytes given back to the upstream resource
+     */
+    std::size_t release_unused(std::size_t max_retained_bytes = 0);
+
+    /// Get the number of allocations served from the cache
+    std::size_t cache_hits() const;
+    /// Get the number of cacheable allocations that went to upstream
+    std::size_t cache_misses() const;
+    /// Get the total size of the blocks currently in the cache
+    std::size_t cached_bytes() const;
+
+private:
+    /// @name Functions implemented from @c vecmem::memory_resource
+    /// @{
+
+    /// Allocate a blob of memory
+    virtual void* do_allocate(std::size_t, std::size_t) override;
+    /// De-allocate a previously allocated memory blob
+    virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+
+    /// @}
+
+    /// Object implementing the memory resource's logic
+    std::unique_ptr<details::caching_memory_resource_impl> m_impl;
+
+};  // class caching_memory_resource
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
@@ -11,6 +11,8 @@
 #include <cstddef>
 #include <functional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "vecmem/memory/details/memory_resource_base.hpp"
 #include "vecmem/memory/memory_resource.hpp"
@@ -27,6 +29,10 @@ namespace vecmem {
  *
  * This resource can be used to construct complex conditional allocation
  * schemes.
+ *
+ * De-allocations are routed back to the upstream resources that can claim
+ * the memory through @c vecmem::details::memory_resource_base::owns(...).
+ * Only allocations that could not be routed that way are recorded in a map.
  */
 class VECMEM_CORE_EXPORT choice_memory_resource final
     : public details::memory_resource_base {
@@ -46,6 +52,15 @@ private:
 
     virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
 
+    /// Find the first upstream resource claiming the ownership of a pointer
+    memory_resource* find_owner(const void* p) const;
+
+    /// The upstream resources chosen so far, in the order of first use, with
+    /// the interface to answer @c owns(...) with (or @c nullptr)
+    std::vector<
+        std::pair<memory_resource*, const details::memory_resource_base*>>
+        m_upstreams;
+
     std::unordered_map<void*, std::reference_wrapper<memory_resource>>
         m_allocations;
 
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <unordered_map>
 #include <vector>
@@ -25,6 +26,20 @@ namespace vecmem {
 /**
  * @brief This memory resource tries to allocate with several upstream resources
  * and returns the first succesful one.
+ *
+ * De-allocations are routed back to the upstream resources that can claim
+ * the memory through @c vecmem::details::memory_resource_base::owns(...).
+ * Only allocations that could not be routed that way (because the upstream
+ * resource can not tell that it owns them, or because an earlier upstream
+ * resource would claim them) are recorded in a map.
+ *
+ * Upstream resources are asked for memory through
+ * @c vecmem::details::memory_resource_base::try_allocate(...) where possible,
+ * to avoid exceptions being thrown for every failing upstream resource. The
+ * resource also remembers which upstream resources failed to allocate blocks
+ * of a given size class (and larger), and skips them for such allocations
+ * until memory is returned to them. They are only tried again before the
+ * allocation would fail otherwise.
  */
 class VECMEM_CORE_EXPORT coalescing_memory_resource final
     : public details::memory_resource_base {
@@ -46,10 +61,29 @@ private:
 
     virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
 
+    virtual void* do_try_allocate(std::size_t, std::size_t) override;
+
+    /// Find the index of the first upstream resource claiming a pointer
+    std::size_t find_owner(const void* p) const;
+
+    /// Try to allocate memory with one upstream resource, without throwing
+    void* try_upstream(std::size_t i, std::size_t size, std::size_t align);
+
+    /// Remember which upstream resource made an allocation, if necessary
+    void* record(std::size_t i, void* ptr);
+
     const std::vector<std::reference_wrapper<memory_resource>> m_upstreams;
 
-    std::unordered_map<void*, std::reference_wrapper<memory_resource>>
-        m_allocations;
+    /// The upstream resources implementing the extended interface, or
+    /// @c nullptr
+    std::vector<details::memory_resource_base*> m_bases;
+
+    /// The size classes that the upstream resources recently failed to
+    /// allocate, as bit masks
+    std::vector<std::uint64_t> m_failed_classes;
+
+    /// The upstream resources of the allocations not routable by ownership
+    std::unordered_map<void*, std::size_t> m_allocations;
 };
 }  // namespace vecmem
 
@@ -47,6 +47,8 @@ private:
 
     virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
 
+    virtual void* do_try_allocate(std::size_t, std::size_t) override;
+
     memory_resource& m_upstream;
 
     std::function<bool(std::size_t, std::size_t)> m_pred;
@@ -13,7 +13,18 @@
 #include "vecmem/vecmem_core_export.hpp"
 
 // System include(s).
+#include <atomic>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
 
 namespace vecmem {
 
@@ -28,9 +39,19 @@ namespace vecmem {
  * allocator guarantees that each consecutive allocation will start right at
  * the end of the previous.
  *
- * @note The allocation size on the upstream allocator is also the maximum
- * amount of memory that can be allocated from the contiguous memory
- * resource.
+ * Allocations only advance a single "bump pointer" with an atomic
+ * compare-and-swap, so the memory resource can be used by multiple threads at
+ * the same time. Individual de-allocations are no-ops, but the memory can be
+ * reclaimed all at once with @c reset(), or back to a previously taken
+ * marker with @c rewind(...). Which allows re-using the same memory blob for
+ * example for the scratch memory of every event.
+ *
+ * @note By default the allocation size on the upstream allocator is also the
+ * maximum amount of memory that can be allocated from the contiguous memory
+ * resource. In "growable" mode further, geometrically growing chunks are
+ * allocated from the upstream resource whenever the current one is
+ * exhausted. In which case allocations are only contiguous within a single
+ * chunk.
  */
 class VECMEM_CORE_EXPORT contiguous_memory_resource final
     : public details::memory_resource_base {
@@ -44,6 +65,18 @@ public:
      */
     contiguous_memory_resource(memory_resource& upstream, std::size_t size);
 
+    /**
+     * @brief Constructs a growable contiguous memory resource.
+     *
+     * @param[in] upstream The upstream memory resource to use.
+     * @param[in] size The size of the first chunk of memory to allocate
+     *                 upstream.
+     * @param[in] growth_factor The factor by which every new chunk is larger
+     *                          than the previous one.
+     */
+    contiguous_memory_resource(memory_resource& upstream, std::size_t size,
+                               std::size_t growth_factor);
+
     /**
      * @brief Deconstruct the contiguous memory resource.
      *
@@ -51,6 +84,46 @@ public:
      */
     ~contiguous_memory_resource();
 
+    /// Position in the memory resource, as returned by @c mark()
+    struct marker {
+        /// Index of the chunk that the position is in
+        std::size_t m_chunk;
+        /// Offset of the position from the start of the chunk
+        std::size_t m_offset;
+    };
+
+    /**
+     * @brief Get the current position of the memory resource.
+     *
+     * @return A marker that @c rewind(...) can go back to
+     */
+    marker mark() const;
+
+    /**
+     * @brief Go back to a previously taken marker.
+     *
+     * All memory allocated since the marker was taken becomes available for
+     * new allocations, so it must not be in use anymore. Chunks allocated
+     * after the marker are kept, and are re-used once the allocations reach
+     * them again. This function must not be called concurrently with
+     * allocations from other threads.
+     *
+     * @param[in] m The marker to go back to
+     *
+     * @throws std::invalid_argument If the marker does not point into the
+     *         current chunks (for instance after a @c reset())
+     */
+    void rewind(marker m);
+
+    /**
+     * @brief Make all of the memory available again.
+     *
+     * All chunks but the first one are given back to the upstream resource,
+     * and allocations start again from the beginning of the first chunk. It
+     * must not be called concurrently with allocations from other threads.
+     */
+    void reset();
+
 private:
     /// @name Function(s) implemented from @c vecmem::memory_resource
     /// @{
@@ -62,15 +135,54 @@ private:
 
     /// @}
 
-    /// Upstream memory resource to allocate the one memory blob with
+    /// Allocate memory without throwing, once a fixed size resource is full
+    virtual void* do_try_allocate(std::size_t, std::size_t) override;
+
+    /// Check whether a pointer is in one of the chunks of the resource
+    virtual ownership do_owns(const void* p) const noexcept override;
+
+    /// A memory blob allocated from upstream
+    struct chunk {
+        /// Index of the chunk in @c m_chunks
+        std::size_t m_index;
+        /// Pointer to the beginning of the chunk
+        char* m_begin;
+        /// Size of the chunk
+        std::size_t m_size;
+        /// Pointer to the next free memory block to give out from the chunk
+        std::atomic<char*> m_next;
+        /// The chunk following this one, for look-ups without the lock
+        std::atomic<chunk*> m_following{nullptr};
+    };
+
+    /// Allocate a new chunk from upstream, and append it to @c m_chunks
+    chunk* add_chunk(std::size_t size);
+    /// Give the chunks from the specified index onwards back to upstream
+    void release_chunks(std::size_t index);
+
+    /// Make another chunk the current one, once the current one is exhausted
+    void next_chunk(chunk* exhausted, std::size_t size, std::size_t alignment);
+
+    /// Upstream memory resource to allocate the memory chunks with
     memory_resource& m_upstream;
-    /// Size of memory to allocate upstream
-    const std::size_t m_size;
-    /// Pointer to the memory blob allocated from upstream
-    void* const m_begin;
-    /// Pointer to the next free memory block to give out
-    void* m_next;
+    /// Growth factor of the chunks, 0 for a single, fixed size chunk
+    const std::size_t m_growth_factor;
+    /// All chunks allocated from upstream, in order
+    std::vector<std::unique_ptr<chunk>> m_chunks;
+    /// The first chunk, which is never given back to upstream
+    chunk* m_first;
+    /// Released chunks, that @c do_owns(...) may still be looking at
+    std::vector<std::unique_ptr<chunk>> m_retired;
+    /// The chunk that allocations are currently made from
+    std::atomic<chunk*> m_current;
+    /// Lock serialising the switching to new chunks
+    mutable std::mutex m_mutex;
 
 };  // class contiguous_memory_resource
 
 }  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
@@ -9,7 +9,8 @@
 #pragma once
 
 #include <cstddef>
-#include <unordered_map>
+#include <map>
+#include <mutex>
 
 #include "vecmem/memory/details/memory_resource_base.hpp"
 #include "vecmem/memory/memory_resource.hpp"
@@ -26,6 +27,16 @@ namespace vecmem {
  *
  * For example, this memory resource can be used to catch overlapping
  * allocations, double frees, invalid frees, and other memory integrity issues.
+ *
+ * Outstanding allocations are kept in a map ordered by address, so checking
+ * a new allocation for overlaps takes logarithmic time. To reduce the
+ * overhead further, the memory resource can be set up to only validate one
+ * in N allocations, counting the allocation requests. The address range of
+ * every outstanding allocation is still recorded, so a validated allocation
+ * is checked for overlaps with all of them, and invalid / double frees are
+ * reported for all pointers. Only the overlap checks of the other
+ * allocations, and the size / alignment checks of their de-allocations, are
+ * skipped.
  */
 class VECMEM_CORE_EXPORT debug_memory_resource final
     : public details::memory_resource_base {
@@ -34,18 +45,41 @@ public:
      * @brief Constructs the debug memory resource.
      *
      * @param[in] upstream The upstream memory resource to use.
+     * @param[in] sampling_rate Validate only one in this many allocations.
+     */
+    debug_memory_resource(memory_resource& upstream,
+                          std::size_t sampling_rate = 1);
+
+    /**
+     * @brief Check whether an outstanding allocation is being validated.
      */
-    debug_memory_resource(memory_resource& upstream);
+    bool is_sampled(const void* ptr) const;
 
 private:
     virtual void* do_allocate(std::size_t, std::size_t) override;
 
     virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
 
+    /// The record of an outstanding allocation
+    struct allocation {
+        /// The size of the allocation
+        std::size_t m_size;
+        /// The alignment of the allocation
+        std::size_t m_align;
+        /// Whether the allocation is validated
+        bool m_sampled;
+    };
+
     memory_resource& m_upstream;
 
-    std::unordered_map<void*, std::pair<std::size_t, std::size_t>>
-        m_allocations;
+    std::size_t m_sampling_rate;
+
+    mutable std::mutex m_mutex;
+
+    /// The number of allocations made, for selecting the validated ones
+    std::size_t m_n_allocations = 0;
+
+    std::map<void*, allocation> m_allocations;
 };
 }  // namespace vecmem
 
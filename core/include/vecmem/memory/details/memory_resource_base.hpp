@@ -11,6 +11,9 @@
 #include "vecmem/memory/memory_resource.hpp"
 #include "vecmem/vecmem_core_export.hpp"
 
+// System include(s).
+#include <cstddef>
+
 // Disable the warning(s) about inheriting from/using standard library types
 // with an exported class.
 #ifdef _MSC_VER
@@ -37,6 +40,34 @@ public:
     /// Inherit the base class's constructor(s)
     using vecmem::memory_resource::memory_resource;
 
+    /// The possible answers to whether a memory resource owns some memory
+    enum class ownership {
+        unknown,   ///< The memory resource can not tell
+        owned,     ///< The memory was allocated by the memory resource
+        not_owned  ///< The memory was not allocated by the memory resource
+    };
+
+    /// Check whether a pointer was allocated by this memory resource
+    ///
+    /// Memory resources managing well defined address ranges (pools) can
+    /// answer this without any per-allocation bookkeeping, which allows other
+    /// memory resources to route de-allocations to them cheaply. Others
+    /// answer with @c ownership::unknown.
+    ///
+    ownership owns(const void *p) const noexcept;
+
+    /// Try to allocate memory, without throwing on failure
+    ///
+    /// Memory resources that know up front that they can not satisfy an
+    /// allocation implement this without going through an exception. For
+    /// all others the @c std::bad_alloc exception of @c allocate(...) is
+    /// caught.
+    ///
+    /// @return The allocated memory, or @c nullptr if the allocation failed
+    ///
+    void *try_allocate(std::size_t bytes,
+                       std::size_t alignment = alignof(std::max_align_t));
+
 protected:
     /// @name Function(s) implemented from @c vecmem::memory_resource
     /// @{
@@ -47,8 +78,26 @@ protected:
 
     /// @}
 
+    /// Implementation of @c owns(...), answering @c ownership::unknown
+    virtual ownership do_owns(const void *p) const noexcept;
+
+    /// Implementation of @c try_allocate(...), catching @c std::bad_alloc
+    virtual void *do_try_allocate(std::size_t bytes, std::size_t alignment);
+
 };  // class memory_resource_base
 
+/// Try to allocate memory from any memory resource, without throwing on
+/// failure
+///
+/// Uses @c vecmem::details::memory_resource_base::try_allocate(...) when the
+/// memory resource provides it, and catches @c std::bad_alloc otherwise.
+///
+/// @return The allocated memory, or @c nullptr if the allocation failed
+///
+VECMEM_CORE_EXPORT
+void *try_allocate(memory_resource &resource, std::size_t bytes,
+                   std::size_t alignment = alignof(std::max_align_t));
+
 }  // namespace vecmem::details
 
 // Re-enable the warning(s).
@@ -0,0 +1,139 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/details/memory_resource_base.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+/**
+ * @brief Terminal memory resource carving memory out of a mapped file.
+ *
+ * The memory resource maps a file into memory (with @c MAP_SHARED), and
+ * hands out consecutive pieces of the mapping, much like
+ * @c vecmem::contiguous_memory_resource does with the memory that it gets
+ * from its upstream resource. The pages of the file are read in lazily by
+ * the operating system when they are first accessed, and written back to the
+ * file by it as well, so buffers larger than the available RAM can be put
+ * into the file.
+ *
+ * Since the allocations are made at deterministic offsets, re-opening a file
+ * and making the same sequence of allocations gives back the data that was
+ * written into the file previously.
+ *
+ * Individual de-allocations are no-ops, all memory can be reclaimed at once
+ * with @c reset(). The memory resource is only available on POSIX systems.
+ */
+class VECMEM_CORE_EXPORT file_mapped_memory_resource final
+    : public details::memory_resource_base {
+
+public:
+    /// Hints about the expected access pattern of the memory
+    enum class access_hint {
+        normal,      ///< No special treatment
+        sequential,  ///< Memory is accessed sequentially
+        random       ///< Memory is accessed in a random order
+    };
+
+    /**
+     * @brief Constructs the file mapped memory resource.
+     *
+     * The file is created if it does not exist yet, and it is extended to
+     * @c size bytes if it is smaller than that. Its existing contents are
+     * kept.
+     *
+     * @param[in] path The path of the file to map
+     * @param[in] size The size of the file to map (0 for the full size of an
+     *                 existing file)
+     * @param[in] hint The expected access pattern of the memory
+     *
+     * @throws std::runtime_error If the file could not be opened or mapped
+     */
+    file_mapped_memory_resource(const std::string& path, std::size_t size,
+                                access_hint hint = access_hint::normal);
+
+    /**
+     * @brief Destructor, un-mapping the file.
+     */
+    ~file_mapped_memory_resource();
+
+    /// Get the size of the mapped file
+    std::size_t size() const;
+    /// Get the offset of an allocation in the file
+    std::size_t offset_of(const void* p) const;
+
+    /**
+     * @brief Write the modified memory back into the file.
+     *
+     * @param[in] wait Whether to wait for the writing to finish
+     */
+    void sync(bool wait = true);
+
+    /**
+     * @brief Ask the operating system to start reading in a memory region.
+     *
+     * @param[in] p The beginning of the memory region
+     * @param[in] size The size of the memory region
+     */
+    void prefetch(const void* p, std::size_t size) const;
+
+    /**
+     * @brief Reclaim all memory, starting allocating from the beginning of
+     *        the file again.
+     */
+    void reset();
+
+private:
+    /// @name Function(s) implemented from @c vecmem::memory_resource
+    /// @{
+
+    /// Allocate memory from the mapped file
+    virtual void* do_allocate(std::size_t, std::size_t) override;
+    /// De-allocate a block of previously allocated memory (a no-op)
+    virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+
+    /// @}
+
+    /// Allocate memory without throwing, once the file is full
+    virtual void* do_try_allocate(std::size_t, std::size_t) override;
+
+    /// Check whether a pointer is in the mapped file
+    virtual ownership do_owns(const void* p) const noexcept override;
+
+    /// The file descriptor of the mapped file
+    int m_fd;
+    /// The beginning of the mapping
+    char* m_begin;
+    /// The size of the mapping
+    std::size_t m_size;
+    /// The beginning of the unallocated part of the mapping
+    std::atomic<char*> m_next;
+
+};  // class file_mapped_memory_resource
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
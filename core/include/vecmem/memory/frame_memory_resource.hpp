@@ -0,0 +1,116 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/details/memory_resource_base.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+// Forward declaration(s).
+class contiguous_memory_resource;
+
+/**
+ * @brief Memory resource handing out memory for a rotating set of "frames".
+ *
+ * It is meant for applications processing a new event (frame) while the
+ * results of the previous event(s) are still in use, for instance while they
+ * are being copied out. The memory resource holds a fixed number of
+ * monotonic (growable @c vecmem::contiguous_memory_resource) arenas, and all
+ * allocations are made from the arena of the current frame. Individual
+ * de-allocations are no-ops.
+ *
+ * Calling @c begin_frame() moves on to the next arena, reclaiming all memory
+ * allocated in it the last time that it was used, all at once. So memory
+ * allocated for a frame stays valid until @c begin_frame() is called as many
+ * times as there are frames in the memory resource. The arenas keep all the
+ * memory that they grew to, so frames of a similar size do not make any
+ * requests to the upstream resource. The memory is only given back to
+ * upstream when the memory resource is destroyed.
+ */
+class VECMEM_CORE_EXPORT frame_memory_resource final
+    : public details::memory_resource_base {
+
+public:
+    /**
+     * @brief Constructs the frame memory resource.
+     *
+     * @param[in] upstream The upstream memory resource to use
+     * @param[in] frame_size The initial size of the arena of every frame
+     * @param[in] n_frames The number of frames in use at the same time (at
+     *                     least 2)
+     * @param[in] growth_factor The factor by which the arenas grow, when a
+     *                          frame needs more memory than what its arena
+     *                          currently has
+     */
+    frame_memory_resource(memory_resource& upstream, std::size_t frame_size,
+                          std::size_t n_frames = 2,
+                          std::size_t growth_factor = 2);
+
+    /**
+     * @brief Destructor, giving the memory of all frames back to upstream.
+     */
+    ~frame_memory_resource();
+
+    /**
+     * @brief Move on to the next frame.
+     *
+     * All memory allocated the last time that the arena of the next frame
+     * was used is reclaimed, so it must not be in use anymore. This function
+     * must not be called concurrently with allocations from other threads.
+     */
+    void begin_frame();
+
+    /// Get the number of frames begun since construction
+    std::size_t current_frame() const;
+
+    /// Get the number of frames in use at the same time
+    std::size_t n_frames() const;
+
+private:
+    /// @name Function(s) implemented from @c vecmem::memory_resource
+    /// @{
+
+    /// Allocate memory from the arena of the current frame
+    virtual void* do_allocate(std::size_t, std::size_t) override;
+    /// De-allocate a block of previously allocated memory (a no-op)
+    virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+
+    /// @}
+
+    /// Check whether a pointer is in the arena of any of the frames
+    virtual ownership do_owns(const void* p) const noexcept override;
+
+    /// The arenas of the frames
+    std::vector<std::unique_ptr<contiguous_memory_resource>> m_arenas;
+    /// The number of frames begun since construction
+    std::atomic<std::size_t> m_frame;
+
+};  // class frame_memory_resource
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
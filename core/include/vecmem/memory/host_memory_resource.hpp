@@ -12,6 +12,9 @@
 #include "vecmem/memory/details/memory_resource_base.hpp"
 #include "vecmem/vecmem_core_export.hpp"
 
+// System include(s).
+#include <cstddef>
+
 namespace vecmem {
 
 /**
@@ -20,10 +23,40 @@ namespace vecmem {
  * This is probably the simplest memory resource you can possibly write. It
  * is a terminal resource which does nothing but wrap malloc and free. It
  * is state-free (on the relevant levels of abstraction).
+ *
+ * Alignments larger than what @c malloc guarantees are honoured using
+ * @c posix_memalign (@c _aligned_malloc on Windows).
+ *
+ * Optionally, large allocations can be backed by (2 MiB) transparent huge
+ * pages, to reduce the number of TLB misses when accessing them. Such
+ * allocations are aligned to, and padded to a multiple of, the huge page
+ * size, and are advised to the kernel with @c madvise(MADV_HUGEPAGE) on
+ * Linux. On other platforms only the alignment is applied.
  */
 class VECMEM_CORE_EXPORT host_memory_resource final
     : public details::memory_resource_base {
 
+public:
+    /// The size of the huge pages used for large allocations
+    static constexpr std::size_t huge_page_size = 2UL * 1024UL * 1024UL;
+
+    /**
+     * @brief Default constructor, not using huge pages.
+     */
+    host_memory_resource() = default;
+
+    /**
+     * @brief Constructor enabling huge pages for large allocations.
+     *
+     * @param[in] huge_page_threshold The size (in bytes) starting from which
+     *                                allocations are backed by huge pages
+     *                                (0 turns huge pages off)
+     */
+    explicit host_memory_resource(std::size_t huge_page_threshold);
+
+    /// Get the size starting from which huge pages are used (0 if never)
+    std::size_t huge_page_threshold() const;
+
 private:
     /// @name Function(s) implemented from @c vecmem::memory_resource
     /// @{
@@ -32,12 +65,17 @@ private:
     virtual void* do_allocate(std::size_t, std::size_t) override;
     /// De-allocate a block of previously allocated memory
     virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+    /// Allocate standard host memory, without throwing on failure
+    virtual void* do_try_allocate(std::size_t, std::size_t) override;
     /// Compares @c *this for equality with @c other
     virtual bool do_is_equal(
         const memory_resource& other) const noexcept override;
 
     /// @}
 
+    /// The size starting from which huge pages are used (0 if never)
+    std::size_t m_huge_page_threshold = 0;
+
 };  // class host_memory_resource
 
 }  // namespace vecmem
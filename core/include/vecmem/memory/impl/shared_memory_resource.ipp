@@ -0,0 +1,100 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// System include(s).
+#include <cstdint>
+
+namespace vecmem {
+
+template <typename TYPE>
+shared_memory_resource::vector_descriptor shared_memory_resource::export_view(
+    const data::vector_view<TYPE>& view) const {
+
+    /*
+     * Express all pointers of the view as offsets in the segment.
+     */
+    return {view.capacity(),
+            (view.size_ptr() == nullptr ? npos : offset_of(view.size_ptr())),
+            (view.ptr() == nullptr ? npos : offset_of(view.ptr()))};
+}
+
+template <typename TYPE>
+shared_memory_resource::jagged_vector_descriptor
+shared_memory_resource::export_view(
+    const data::jagged_vector_view<TYPE>& view) const {
+
+    /*
+     * The array describing the inner vectors holds pointers valid in this
+     * process. So the importing process needs to know where the segment is
+     * mapped here, to be able to translate them.
+     */
+    return {view.m_size,
+            (view.m_ptr == nullptr ? npos : offset_of(view.m_ptr)),
+            static_cast<std::uint64_t>(
+                reinterpret_cast<std::uintptr_t>(m_begin))};
+}
+
+template <typename TYPE>
+data::vector_view<TYPE> shared_memory_resource::import_vector(
+    const vector_descriptor& desc) const {
+
+    using view_type = data::vector_view<TYPE>;
+    typename view_type::pointer ptr =
+        (desc.m_offset == npos
+             ? nullptr
+             : static_cast<typename view_type::pointer>(
+                   at_offset(desc.m_offset)));
+    if (desc.m_size_offset == npos) {
+        return {static_cast<typename view_type::size_type>(desc.m_capacity),
+                ptr};
+    }
+    return {static_cast<typename view_type::size_type>(desc.m_capacity),
+            static_cast<typename view_type::size_pointer>(
+                at_offset(desc.m_size_offset)),
+            ptr};
+}
+
+template <typename TYPE>
+data::jagged_vector_data<TYPE> shared_memory_resource::import_jagged_vector(
+    const jagged_vector_descriptor& desc, memory_resource& resource) const {
+
+    data::jagged_vector_data<TYPE> result(desc.m_size, resource);
+    if (desc.m_offset == npos) {
+        return result;
+    }
+
+    /*
+     * Translate the pointers of the exporting process to pointers of this
+     * one, for every inner vector.
+     */
+    const data::vector_view<TYPE>* exported =
+        static_cast<const data::vector_view<TYPE>*>(at_offset(desc.m_offset));
+    auto translate = [this, &desc](auto* p) -> decltype(p) {
+        if (p == nullptr) {
+            return nullptr;
+        }
+        const std::uint64_t address = static_cast<std::uint64_t>(
+            reinterpret_cast<std::uintptr_t>(p));
+        return static_cast<decltype(p)>(
+            at_offset(static_cast<std::size_t>(address - desc.m_base)));
+    };
+    for (std::size_t i = 0; i < desc.m_size; ++i) {
+        data::vector_view<TYPE> inner = exported[i];
+        if (inner.size_ptr() == nullptr) {
+            result.m_ptr[i] = {inner.capacity(), translate(inner.ptr())};
+        } else {
+            result.m_ptr[i] = {inner.capacity(), translate(inner.size_ptr()),
+                               translate(inner.ptr())};
+        }
+    }
+    return result;
+}
+
+}  // namespace vecmem
@@ -9,11 +9,15 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "vecmem/memory/details/memory_resource_base.hpp"
 #include "vecmem/memory/memory_resource.hpp"
+#include "vecmem/utils/histogram.hpp"
 #include "vecmem/vecmem_core_export.hpp"
 
 #ifdef _MSC_VER
@@ -22,6 +26,10 @@
 #endif
 
 namespace vecmem {
+namespace details {
+struct instrumenting_shard;
+}  // namespace details
+
 /**
  * @brief This memory resource forwards allocation and deallocation requests to
  * the upstream resource while recording useful statistics and information
@@ -29,6 +37,25 @@ namespace vecmem {
  *
  * This allocator is here to allow us to debug, to profile, to test, but also
  * to instrument user code.
+ *
+ * What is recorded is configurable. Either all events are kept (the
+ * default), or only the latest ones in a fixed size ring buffer, or no
+ * individual events at all. Aggregate statistics (counters and histograms)
+ * are collected in all modes, so the latter two can be left on in long
+ * running jobs without their memory use growing. Time measurements can be
+ * made with a cheaper, CPU tick counter based clock, and only for every
+ * N-th request, or not at all.
+ *
+ * The resource can be used from multiple threads at the same time (if its
+ * upstream resource can be). The aggregate statistics are collected in
+ * per-thread shards, which are only summed up when they are read, so in
+ * @c recording::aggregate mode threads do not need to synchronise with each
+ * other. There is one shard per hardware thread (but at least 16, and at
+ * most 64), so with more threads than that some of them share a shard, and
+ * contend on its atomic counters. Recording individual events requires a
+ * lock. Hooks must be added
+ * before the resource is used concurrently, and they must themselves be
+ * thread-safe in that case.
  */
 class VECMEM_CORE_EXPORT instrumenting_memory_resource final
     : public details::memory_resource_base {
@@ -50,10 +77,20 @@ public:
          * @param[in] a The alignment of the request.
          * @param[in] p The pointer that was returned or deallocated.
          * @param[in] ns The time taken to perform the request in nanoseconds.
+         * @param[in] start The start of the request, in nanoseconds on
+         *                  @c std::chrono::steady_clock.
+         * @param[in] thread The number of the thread making the request.
          */
         memory_event(type t, std::size_t s, std::size_t a, void* p,
-                     std::size_t ns)
-            : m_type(t), m_size(s), m_align(a), m_ptr(p), m_time(ns) {}
+                     std::size_t ns, std::uint64_t start = 0,
+                     std::size_t thread = 0)
+            : m_type(t),
+              m_size(s),
+              m_align(a),
+              m_ptr(p),
+              m_time(ns),
+              m_start(start),
+              m_thread(thread) {}
 
         type m_type;
 
@@ -63,6 +100,55 @@ public:
         void* m_ptr;
 
         std::size_t m_time;
+
+        /// The start of the request, on @c std::chrono::steady_clock [ns]
+        std::uint64_t m_start;
+        /// Small number identifying the thread that made the request
+        std::size_t m_thread;
+    };
+
+    /// The possible ways of recording the memory events
+    enum class recording {
+        full,         ///< Keep all events
+        ring_buffer,  ///< Keep only the latest events
+        aggregate     ///< Only collect the aggregate statistics
+    };
+
+    /// The possible ways of timing the requests
+    enum class timing {
+        precise,  ///< Use @c std::chrono::high_resolution_clock
+        ticks,    ///< Use the (cheaper) tick counter of the CPU
+        none      ///< Do not time the requests
+    };
+
+    /**
+     * @brief Aggregate statistics about the requests to the resource.
+     */
+    struct VECMEM_CORE_EXPORT statistics {
+        /// The number of successful allocations
+        std::size_t m_n_allocations = 0;
+        /// The number of failed allocations
+        std::size_t m_n_failed_allocations = 0;
+        /// The number of de-allocations
+        std::size_t m_n_deallocations = 0;
+        /// The total number of bytes allocated
+        std::size_t m_allocated_bytes = 0;
+        /// The total number of bytes de-allocated
+        std::size_t m_deallocated_bytes = 0;
+        /// The number of timed allocations
+        std::size_t m_n_timed_allocations = 0;
+        /// The total time of the timed allocations, in nanoseconds
+        std::size_t m_allocation_time = 0;
+        /// The number of timed de-allocations
+        std::size_t m_n_timed_deallocations = 0;
+        /// The total time of the timed de-allocations, in nanoseconds
+        std::size_t m_deallocation_time = 0;
+        /// Histogram of the sizes of the successful allocations
+        histogram m_size_histogram;
+        /// Histogram of the (timed) allocation times, in nanoseconds
+        histogram m_allocation_time_histogram;
+        /// Histogram of the (timed) de-allocation times, in nanoseconds
+        histogram m_deallocation_time_histogram;
     };
 
     /**
@@ -72,11 +158,41 @@ public:
      */
     instrumenting_memory_resource(memory_resource& upstream);
 
+    /**
+     * @brief Constructs the instrumenting memory resource with a custom
+     * recording policy.
+     *
+     * @param[in] upstream The upstream memory resource to use.
+     * @param[in] mode The way to record the memory events.
+     * @param[in] capacity The number of events to keep in
+     *                     @c recording::ring_buffer mode.
+     * @param[in] clock The way to time the requests.
+     * @param[in] timing_sample_rate Time only every N-th request (events not
+     *                               timed have a time of 0).
+     */
+    instrumenting_memory_resource(memory_resource& upstream, recording mode,
+                                  std::size_t capacity = 0,
+                                  timing clock = timing::precise,
+                                  std::size_t timing_sample_rate = 1);
+
+    /**
+     * @brief Destructor.
+     */
+    ~instrumenting_memory_resource();
+
     /**
      * @brief Return a list of memory allocation and deallocation events in
      * chronological order.
+     *
+     * In @c recording::ring_buffer mode only the latest events are returned,
+     * and in @c recording::aggregate mode none at all.
      */
-    const std::vector<memory_event>& get_events(void) const;
+    std::vector<memory_event> get_events(void) const;
+
+    /**
+     * @brief Return the aggregate statistics about the requests.
+     */
+    statistics get_statistics(void) const;
 
     /**
      * @brief Add a pre-allocation hook.
@@ -94,7 +210,9 @@ public:
      *
      * Whenever memory is allocated, all post-allocation hooks are exectuted.
      * This happens after we know whether the allocation was a success or not,
-     * and the pointer that was returned.
+     * and the pointer that was returned. The hooks also run (with a null
+     * pointer) if the upstream resource throws an exception, before that
+     * exception is passed on.
      *
      * The function passed to this function should accept the size of the
      * request as the first argument, the alignment as the second, and the
@@ -116,22 +234,89 @@ public:
     void add_pre_deallocate_hook(
         std::function<void(void*, std::size_t, std::size_t)> f);
 
+    /**
+     * @brief Add a post-deallocation hook.
+     *
+     * Whenever memory is deallocated, all post-deallocation hooks are
+     * executed, after the memory was handed back to the upstream resource.
+     * They also run if the upstream resource throws an exception, before
+     * that exception is passed on.
+     *
+     * The function passed to this function should accept the pointer to
+     * deallocate as its first argument, the size of the request as the second
+     * argument, and the alignment as the third.
+     */
+    void add_post_deallocate_hook(
+        std::function<void(void*, std::size_t, std::size_t)> f);
+
 private:
     virtual void* do_allocate(std::size_t, std::size_t) override;
 
     virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
 
+    /*
+     * Decide whether the next request should be timed.
+     */
+    bool time_request();
+
+    /*
+     * Read the clock used for timing the requests.
+     */
+    std::uint64_t now() const;
+
+    /*
+     * Get the time elapsed since a reading of the clock, in nanoseconds.
+     */
+    std::size_t elapsed(std::uint64_t start) const;
+
+    /*
+     * Record a finished (possibly failed) allocation, and run the
+     * post-allocation hooks.
+     */
+    void finish_allocation(std::size_t size, std::size_t align, void* ptr,
+                           std::size_t time, bool timed, std::uint64_t start);
+
+    /*
+     * Record a finished de-allocation, and run the post-deallocation hooks.
+     */
+    void finish_deallocation(void* ptr, std::size_t size, std::size_t align,
+                             std::size_t time, bool timed,
+                             std::uint64_t start);
+
+    /*
+     * Record an event, according to the recording policy.
+     */
+    void record(memory_event::type t, std::size_t size, std::size_t align,
+                void* ptr, std::size_t time, bool timed, std::uint64_t start);
+
     /*
      * The upstream memory resource to which requests for allocation and
      * deallocation will be forwarded.
      */
     memory_resource& m_upstream;
 
+    /*
+     * The recording policy.
+     */
+    recording m_mode = recording::full;
+    timing m_timing = timing::precise;
+    std::size_t m_timing_sample_rate = 1;
+
     /*
      * This list stores a chronological set of requests that were passed to
-     * this memory resource.
+     * this memory resource. In ring buffer mode the oldest event is at
+     * @c m_next_event once the buffer is full. All of them are protected by
+     * @c m_events_mutex.
      */
     std::vector<memory_event> m_events;
+    std::size_t m_capacity = 0;
+    std::size_t m_next_event = 0;
+    mutable std::mutex m_events_mutex;
+
+    /*
+     * The per-thread shards of the aggregate statistics.
+     */
+    std::unique_ptr<details::instrumenting_shard[]> m_shards;
 
     /*
      * The list of all pre-allocation hooks.
@@ -150,6 +335,12 @@ private:
      */
     std::vector<std::function<void(void*, std::size_t, std::size_t)>>
         m_pre_deallocate_hooks;
+
+    /*
+     * The list of all post-deallocation hooks.
+     */
+    std::vector<std::function<void(void*, std::size_t, std::size_t)>>
+        m_post_deallocate_hooks;
 };
 }  // namespace vecmem
 
@@ -0,0 +1,134 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/details/memory_resource_base.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+/**
+ * @brief Terminal memory resource mapping memory directly from the OS.
+ *
+ * Every allocation is served by its own anonymous memory mapping (made with
+ * @c mmap on POSIX systems, and with @c VirtualAlloc on Windows), so the
+ * memory resource is meant for large allocations. Typically as the upstream
+ * of a pool, like @c vecmem::binary_page_memory_resource or
+ * @c vecmem::arena_memory_resource.
+ *
+ * The memory can be pre-faulted at allocation time, removing the page fault
+ * stalls of its first use. It can also be backed by huge pages, either
+ * transparent ones (requested with @c madvise(MADV_HUGEPAGE)) or ones from
+ * the explicitly reserved huge page pool (with @c MAP_HUGETLB). When the
+ * huge page pool is exhausted, transparent huge pages are used instead.
+ * Huge pages are only used on Linux, they are ignored on other platforms.
+ *
+ * Finally, instead of un-mapping memory when it is de-allocated, the memory
+ * resource can keep the mappings for later allocations of the same size,
+ * until @c release_unused() is called, or the memory resource is destroyed.
+ */
+class VECMEM_CORE_EXPORT mmap_memory_resource final
+    : public details::memory_resource_base {
+
+public:
+    /// The types of huge pages that the memory resource can use
+    enum class huge_pages {
+        none,         ///< Use regular pages only
+        transparent,  ///< Use transparent huge pages
+        hugetlb       ///< Use pages from the reserved huge page pool
+    };
+
+    /// The size of the huge pages used by the memory resource
+    static constexpr std::size_t huge_page_size = 2UL * 1024UL * 1024UL;
+
+    /**
+     * @brief Constructs the mmap memory resource.
+     *
+     * @param[in] populate Whether to pre-fault all memory at allocation time
+     * @param[in] pages The type of huge pages to use
+     * @param[in] unmap_on_free Whether to un-map memory right away when it
+     *                          is de-allocated, or keep it for re-use
+     */
+    explicit mmap_memory_resource(bool populate = false,
+                                  huge_pages pages = huge_pages::none,
+                                  bool unmap_on_free = true);
+
+    /**
+     * @brief Destructor, un-mapping all memory kept for re-use.
+     */
+    ~mmap_memory_resource();
+
+    /// Get the (regular) page size of the system
+    std::size_t page_size() const;
+
+    /**
+     * @brief Un-map all memory kept for re-use.
+     *
+     * @return The number of bytes that were un-mapped
+     */
+    std::size_t release_unused();
+
+    /// Get the number of bytes mapped, but kept for re-use
+    std::size_t retained_bytes() const;
+
+private:
+    /// @name Function(s) implemented from @c vecmem::memory_resource
+    /// @{
+
+    /// Map memory for an allocation
+    virtual void* do_allocate(std::size_t, std::size_t) override;
+    /// Un-map (or keep for re-use) the memory of an allocation
+    virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+
+    /// @}
+
+    /// Get the size that an allocation is mapped with
+    std::size_t mapping_size(std::size_t size) const;
+    /// Map a new region of memory
+    void* map(std::size_t size, std::size_t alignment);
+    /// Un-map a region of memory
+    void unmap(void* p, std::size_t size);
+
+    /// Whether to pre-fault all memory at allocation time
+    bool m_populate;
+    /// The type of huge pages to use
+    huge_pages m_huge_pages;
+    /// Whether to un-map memory right away when it is de-allocated
+    bool m_unmap_on_free;
+    /// The (regular) page size of the system
+    std::size_t m_page_size;
+
+    /// Mutex protecting the mappings kept for re-use
+    mutable std::mutex m_mutex;
+    /// Mappings kept for re-use, by their size
+    std::multimap<std::size_t, void*> m_retained;
+    /// The total size of the mappings kept for re-use
+    std::size_t m_retained_bytes = 0;
+
+};  // class mmap_memory_resource
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
@@ -0,0 +1,104 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/details/memory_resource_base.hpp"
+#include "vecmem/memory/mmap_memory_resource.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <vector>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+/**
+ * @brief Terminal memory resource placing memory on chosen NUMA nodes.
+ *
+ * Every allocation is served by its own memory mapping (using
+ * @c vecmem::mmap_memory_resource), which gets a NUMA memory policy assigned
+ * with the @c mbind system call before it would be touched for the first
+ * time. The memory can either be bound to a single node, be interleaved
+ * between all nodes of the system, or be placed on the node of the thread
+ * making the allocation.
+ *
+ * The system calls are made directly, without a dependency on libnuma. On
+ * machines with a single NUMA node, on platforms other than Linux, and when
+ * setting the memory policy fails (for instance because of the lack of
+ * permissions in a container), the memory resource behaves exactly like
+ * @c vecmem::mmap_memory_resource.
+ */
+class VECMEM_CORE_EXPORT numa_memory_resource final
+    : public details::memory_resource_base {
+
+public:
+    /// The policies for placing memory on NUMA nodes
+    enum class policy {
+        bind,        ///< Place all memory on the chosen node
+        interleave,  ///< Interleave the pages between all nodes
+        local        ///< Prefer the node of the allocating thread
+    };
+
+    /**
+     * @brief Constructs the NUMA memory resource.
+     *
+     * @param[in] pol The policy to place the allocated memory with
+     * @param[in] node The node to place memory on, with @c policy::bind
+     * @param[in] populate Whether to pre-fault all memory at allocation time
+     */
+    explicit numa_memory_resource(policy pol = policy::local,
+                                  unsigned int node = 0,
+                                  bool populate = false);
+
+    /// Get the policy that memory is placed with
+    policy get_policy() const;
+
+    /// Get the number of NUMA nodes available on the system (at least 1)
+    static unsigned int n_nodes();
+    /// Get the NUMA node of the CPU that the calling thread is running on
+    static unsigned int current_node();
+    /// Get the NUMA node that a page of memory is on (-1 if unknown)
+    static int node_of(const void* p);
+
+private:
+    /// @name Function(s) implemented from @c vecmem::memory_resource
+    /// @{
+
+    /// Allocate memory, with the appropriate NUMA policy
+    virtual void* do_allocate(std::size_t, std::size_t) override;
+    /// De-allocate a block of previously allocated memory
+    virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+
+    /// @}
+
+    /// The policy to place the allocated memory with
+    policy m_policy;
+    /// Node mask used with the bind and interleave policies
+    std::vector<unsigned long> m_nodemask;
+    /// Whether to pre-fault all memory at allocation time
+    bool m_populate;
+    /// The memory resource mapping the memory
+    mmap_memory_resource m_mmap;
+
+};  // class numa_memory_resource
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
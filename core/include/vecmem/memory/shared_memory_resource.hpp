@@ -0,0 +1,210 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/containers/data/jagged_vector_data.hpp"
+#include "vecmem/containers/data/jagged_vector_view.hpp"
+#include "vecmem/containers/data/vector_view.hpp"
+#include "vecmem/memory/details/memory_resource_base.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+/**
+ * @brief Memory resource handing out memory shared between processes.
+ *
+ * The memory resource maps a shared memory segment, either an anonymous one
+ * created with @c memfd_create (which can be passed to other processes as a
+ * file descriptor, or inherited by child processes, and be mapped there
+ * with the @c from_fd constructor), or a named one created / opened with
+ * @c shm_open. Allocations are carved out of the segment with
+ * a bump pointer that is stored in the segment itself, so all processes
+ * mapping the same segment can allocate from it. Individual de-allocations
+ * are no-ops.
+ *
+ * Since the segment is mapped at different addresses in different
+ * processes, buffers placed into it are exported as offset based
+ * descriptors, with @c export_view(...). These can be sent to a consumer
+ * process (through a pipe, for instance), which can create views of the same
+ * memory from them with @c import_vector(...) and
+ * @c import_jagged_vector(...), without copying any of the data.
+ *
+ * The memory resource is only available on POSIX systems.
+ */
+class VECMEM_CORE_EXPORT shared_memory_resource final
+    : public details::memory_resource_base {
+
+public:
+    /// Descriptor of a 1D buffer in the shared memory segment
+    struct vector_descriptor {
+        /// The capacity of the buffer
+        std::size_t m_capacity;
+        /// The offset of the size variable of the buffer (or @c npos)
+        std::size_t m_size_offset;
+        /// The offset of the payload of the buffer
+        std::size_t m_offset;
+    };
+
+    /// Descriptor of a jagged buffer in the shared memory segment
+    struct jagged_vector_descriptor {
+        /// The number of inner vectors in the buffer
+        std::size_t m_size;
+        /// The offset of the array describing the inner vectors
+        std::size_t m_offset;
+        /// The address of the segment in the exporting process
+        std::uint64_t m_base;
+    };
+
+    /// Offset value for "no variable"
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// Tag type selecting the constructor mapping an existing file descriptor
+    struct from_fd_t {
+        explicit from_fd_t() = default;
+    };
+    /// Tag selecting the constructor mapping an existing file descriptor
+    static constexpr from_fd_t from_fd{};
+
+    /**
+     * @brief Constructs the memory resource with an anonymous segment.
+     *
+     * @param[in] size The size of the shared memory segment
+     *
+     * @throws std::runtime_error If the segment could not be created
+     */
+    explicit shared_memory_resource(std::size_t size);
+
+    /**
+     * @brief Constructs the memory resource with a named segment.
+     *
+     * The segment is created if a non-zero size is given, in which case it
+     * must not exist yet. It is removed by the memory resource that created
+     * it, when that is destroyed. With a zero size an existing segment is
+     * opened.
+     *
+     * @param[in] name The name of the shared memory segment
+     * @param[in] size The size of the segment to create (0 to open an
+     *                 existing segment)
+     *
+     * @throws std::runtime_error If the segment could not be created/opened
+     */
+    shared_memory_resource(const std::string& name, std::size_t size);
+
+    /**
+     * @brief Constructs the memory resource with an existing segment.
+     *
+     * Maps a segment received as a file descriptor, for instance the
+     * @c fd() of an anonymous segment in another process, inherited through
+     * @c fork() or received over a UNIX domain socket. The size of the
+     * segment is taken from the descriptor. The memory resource uses a
+     * duplicate of the descriptor, so the caller remains responsible for
+     * closing the one that it passed.
+     *
+     * @param[in] fd The file descriptor of the shared memory segment
+     *
+     * @throws std::runtime_error If the segment could not be mapped
+     */
+    shared_memory_resource(from_fd_t, int fd);
+
+    /**
+     * @brief Destructor, un-mapping the shared memory segment.
+     */
+    ~shared_memory_resource();
+
+    /// Get the file descriptor of the shared memory segment
+    int fd() const;
+    /// Get the size of the shared memory segment
+    std::size_t size() const;
+    /// Get the offset of a pointer in the shared memory segment
+    std::size_t offset_of(const void* p) const;
+    /// Get the pointer at a given offset in the shared memory segment
+    void* at_offset(std::size_t offset) const;
+
+    /**
+     * @brief Reclaim all memory of the segment, in all processes.
+     */
+    void reset();
+
+    /// Export a 1D buffer placed in the shared memory segment
+    template <typename TYPE>
+    vector_descriptor export_view(const data::vector_view<TYPE>& view) const;
+    /// Export a jagged buffer placed in the shared memory segment
+    template <typename TYPE>
+    jagged_vector_descriptor export_view(
+        const data::jagged_vector_view<TYPE>& view) const;
+
+    /// Create a view of an exported 1D buffer
+    template <typename TYPE>
+    data::vector_view<TYPE> import_vector(
+        const vector_descriptor& desc) const;
+    /**
+     * @brief Create a view of an exported jagged buffer.
+     *
+     * @param[in] desc The descriptor of the exported buffer
+     * @param[in] resource Host accessible memory resource to allocate the
+     *                     description of the inner vectors with
+     */
+    template <typename TYPE>
+    data::jagged_vector_data<TYPE> import_jagged_vector(
+        const jagged_vector_descriptor& desc,
+        memory_resource& resource) const;
+
+private:
+    /// @name Function(s) implemented from @c vecmem::memory_resource
+    /// @{
+
+    /// Allocate memory from the shared memory segment
+    virtual void* do_allocate(std::size_t, std::size_t) override;
+    /// De-allocate a block of previously allocated memory (a no-op)
+    virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+
+    /// @}
+
+    /// Allocate memory without throwing, once the segment is full
+    virtual void* do_try_allocate(std::size_t, std::size_t) override;
+
+    /// Check whether a pointer is in the shared memory segment
+    virtual ownership do_owns(const void* p) const noexcept override;
+
+    /// Map the segment, and optionally set up its header
+    void map(bool initialize);
+
+    /// The file descriptor of the shared memory segment
+    int m_fd;
+    /// The name of the segment, if this object created a named one
+    std::string m_name;
+    /// The beginning of the mapping
+    char* m_begin;
+    /// The size of the mapping
+    std::size_t m_size;
+
+};  // class shared_memory_resource
+
+}  // namespace vecmem
+
+// Include the implementation.
+#include "vecmem/memory/impl/shared_memory_resource.ipp"
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
@@ -45,6 +45,8 @@ private:
 
     virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
 
+    virtual void* do_try_allocate(std::size_t, std::size_t) override;
+
     virtual bool do_is_equal(const memory_resource&) const noexcept override;
 };
 }  // namespace vecmem
@@ -0,0 +1,112 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/details/memory_resource_base.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <memory>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+// Forward declaration(s).
+namespace details {
+struct thread_caching_memory_resource_impl;
+}
+
+/**
+ * @brief A memory resource keeping per-thread caches of freed small blocks.
+ *
+ * This is a non-terminal memory resource, meant to be put in front of
+ * another (possibly not thread-safe) memory resource. Small allocations are
+ * rounded up to power-of-two size classes, and every thread keeps a bounded
+ * "magazine" of recently freed blocks for each size class. Allocations are
+ * served from the calling thread's magazines without taking any lock
+ * whenever possible, and only go to the upstream resource when a magazine is
+ * empty.
+ *
+ * The upstream resource is only ever accessed under a lock, so it does not
+ * need to be thread-safe itself. The blocks cached by a thread are given back
+ * to the upstream resource when the thread exits, or when this memory
+ * resource is destroyed, whichever happens first.
+ *
+ * Allocations larger than the largest size class, or with an alignment
+ * requirement stricter than that of @c std::max_align_t, are passed to the
+ * upstream resource directly.
+ */
+class VECMEM_CORE_EXPORT thread_caching_memory_resource final
+    : public details::memory_resource_base {
+
+public:
+    /**
+     * @brief Initialize a thread-caching memory resource on top of an
+     * upstream memory resource.
+     *
+     * @param[in] upstream The upstream memory resource to use
+     * @param[in] max_cached_blocks The maximal number of blocks that a
+     *                              single thread may keep in the cache of a
+     *                              single size class
+     * @param[in] max_block_size The size of the largest size class, rounded
+     *                           up to a power of two
+     */
+    thread_caching_memory_resource(memory_resource& upstream,
+                                   std::size_t max_cached_blocks = 64,
+                                   std::size_t max_block_size = 32768);
+
+    /**
+     * @brief Destructor, giving all cached blocks back to the upstream
+     * resource.
+     */
+    ~thread_caching_memory_resource();
+
+    /**
+     * @brief Give all blocks cached by the calling thread back to the
+     * upstream resource.
+     */
+    void flush();
+
+    /// Get the number of allocations served from a thread's cache
+    std::size_t cache_hits() const;
+    /// Get the number of cacheable allocations that went to upstream
+    std::size_t cache_misses() const;
+    /// Get the fraction of the cacheable allocations served from a cache
+    double hit_rate() const;
+
+private:
+    /// @name Functions implemented from @c vecmem::memory_resource
+    /// @{
+
+    /// Allocate a blob of memory
+    virtual void* do_allocate(std::size_t, std::size_t) override;
+    /// De-allocate a previously allocated memory blob
+    virtual void do_deallocate(void* p, std::size_t, std::size_t) override;
+
+    /// @}
+
+    /// Object implementing the memory resource's logic
+    std::unique_ptr<details::thread_caching_memory_resource_impl> m_impl;
+
+};  // class thread_caching_memory_resource
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
@@ -0,0 +1,148 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/instrumenting_memory_resource.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+
+// Forward declaration(s).
+class tracing_copy;
+namespace details {
+struct chrome_trace_source;
+}  // namespace details
+
+/// Class writing memory and copy events in the Chrome trace event format
+///
+/// The produced JSON files can be opened with @c chrome://tracing, or with
+/// the Perfetto UI (https://ui.perfetto.dev). Every memory request / copy is
+/// shown as a "complete" event on the timeline of the thread that issued it,
+/// with its size, pointer(s) and duration. The amount of memory held from
+/// every memory resource is shown as a counter track.
+///
+/// Events are written to the output stream as they are received, so the
+/// writer does not keep the trace in memory. The writer is thread-safe.
+///
+/// The events of a @c vecmem::instrumenting_memory_resource can either be
+/// written after the fact (if it recorded them), with @c write(...), or be
+/// streamed as they happen, with @c attach(...). In the latter case the
+/// lifetime of the writer must be at least as long as the lifetime of the
+/// memory resource. Copies can be traced using @c vecmem::tracing_copy.
+///
+class VECMEM_CORE_EXPORT chrome_trace_writer {
+
+public:
+    /// Constructor writing into an existing output stream
+    ///
+    /// @param out The stream to write the trace into
+    ///
+    explicit chrome_trace_writer(std::ostream& out);
+    /// Constructor writing into a file
+    ///
+    /// @param path The path of the file to (re-)create
+    ///
+    /// @throws std::runtime_error If the file could not be opened
+    ///
+    explicit chrome_trace_writer(const std::string& path);
+    /// Destructor, finishing the trace
+    ~chrome_trace_writer();
+
+    /// Write the recorded events of an instrumented memory resource
+    ///
+    /// @param resource The resource recording its events
+    /// @param name The name to show the resource with in the trace
+    ///
+    void write(const instrumenting_memory_resource& resource,
+               const std::string& name = "memory");
+
+    /// Stream the events of an instrumented memory resource as they happen
+    ///
+    /// The events are timed independently of the resource's own timing
+    /// policy, and they are written even if the resource does not record
+    /// them itself.
+    ///
+    /// @param resource The resource to observe
+    /// @param name The name to show the resource with in the trace
+    ///
+    void attach(instrumenting_memory_resource& resource,
+                const std::string& name = "memory");
+
+    /// Finish the trace, making it a valid JSON document
+    ///
+    /// Events received after this call are ignored. Called by the
+    /// destructor automatically.
+    ///
+    void close();
+
+private:
+    /// Make @c vecmem::tracing_copy able to write its events
+    friend class tracing_copy;
+
+    /// Write a memory event, coming from a given source
+    void write_memory_event(
+        details::chrome_trace_source& source,
+        const instrumenting_memory_resource::memory_event& event);
+    /// Write a "complete" event into the trace
+    ///
+    /// @param name The name of the event
+    /// @param category The category of the event
+    /// @param start The start of the event on @c std::chrono::steady_clock
+    ///              in nanoseconds
+    /// @param duration The duration of the event in nanoseconds
+    /// @param thread The number of the thread that the event belongs to
+    /// @param args The (JSON formatted) members of the event's arguments
+    ///
+    void write_complete_event(const char* name, const char* category,
+                              std::uint64_t start, std::uint64_t duration,
+                              std::size_t thread, const std::string& args);
+    /// Write a "counter" event into the trace
+    void write_counter_event(const std::string& name, std::uint64_t time,
+                             std::size_t value);
+    /// Write one (formatted) event into the output stream
+    void write_event(const std::string& event);
+
+    /// The file written to, if the writer owns its output
+    std::unique_ptr<std::ostream> m_file;
+    /// The stream written to
+    std::ostream& m_out;
+    /// Mutex protecting the output stream
+    std::mutex m_mutex;
+    /// Whether no event was written into the output yet
+    bool m_first = true;
+    /// Whether the trace was finished already
+    bool m_closed = false;
+    /// The memory resources that the writer is attached to
+    std::list<details::chrome_trace_source> m_sources;
+
+};  // class chrome_trace_writer
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
@@ -22,6 +22,9 @@
 
 namespace vecmem {
 
+// Forward declaration(s).
+class tracing_copy;
+
 /// Class implementing (synchronous) host <-> device memory copies
 ///
 /// Since most of the logic of explicitly copying the payload of vecmem
@@ -183,6 +186,9 @@ protected:
     virtual void do_memset(std::size_t size, void* ptr, int value);
 
 private:
+    /// Make @c vecmem::tracing_copy able to forward to any copy object
+    friend class tracing_copy;
+
     /// Helper function implementing @c memset for jagged vectors
     template <typename TYPE>
     void memset_impl(std::size_t size, data::vector_view<TYPE>* data,
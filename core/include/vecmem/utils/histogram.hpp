@@ -0,0 +1,112 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
+
+namespace vecmem {
+namespace details {
+class atomic_histogram;
+}  // namespace details
+
+/// Histogram of non-negative integer values, with logarithmic bucketing
+///
+/// Similar to an HDR histogram, values are sorted into buckets covering
+/// powers of two, each of which is split into @c sub_buckets linear
+/// sub-buckets. So the relative precision of the recorded values is the same
+/// (about 6%) over the full 64-bit range, while the histogram has a small,
+/// fixed size.
+///
+/// Histograms (with the same layout) can be merged, to combine the
+/// measurements of multiple sources.
+///
+class VECMEM_CORE_EXPORT histogram {
+
+public:
+    /// The number of bits used for the linear sub-buckets
+    static constexpr std::size_t sub_bucket_bits = 4;
+    /// The number of linear sub-buckets in every power of two
+    static constexpr std::size_t sub_buckets = 1UL << sub_bucket_bits;
+    /// The total number of buckets
+    static constexpr std::size_t n_buckets =
+        (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    /// Default constructor
+    histogram();
+
+    /// Record a value (possibly multiple times)
+    void record(std::uint64_t value, std::uint64_t count = 1);
+    /// Add the contents of another histogram to this one
+    void merge(const histogram& other);
+    /// Remove all recorded values
+    void reset();
+
+    /// Get the number of recorded values
+    std::uint64_t count() const;
+    /// Get the smallest recorded value (0 for an empty histogram)
+    std::uint64_t min() const;
+    /// Get the largest recorded value (0 for an empty histogram)
+    std::uint64_t max() const;
+    /// Get the mean of the recorded values (0 for an empty histogram)
+    double mean() const;
+
+    /// Get the value below which a given percentage of the values fall
+    ///
+    /// The result is the upper end of the bucket holding the value with the
+    /// requested rank, limited to the range of the recorded values.
+    ///
+    /// @param percentile The percentile to query, in the range [0, 100]
+    ///
+    std::uint64_t percentile(double percentile) const;
+
+    /// Get the bucket index of a value
+    static std::size_t bucket_index(std::uint64_t value);
+    /// Get the lowest value belonging to a bucket
+    static std::uint64_t bucket_lower_bound(std::size_t index);
+    /// Get the highest value belonging to a bucket
+    static std::uint64_t bucket_upper_bound(std::size_t index);
+    /// Get the number of values recorded in a bucket
+    std::uint64_t bucket_count(std::size_t index) const;
+
+private:
+    /// The lock-free version of the histogram fills this one directly
+    friend class details::atomic_histogram;
+
+    /// The number of values in each bucket
+    std::vector<std::uint64_t> m_counts;
+    /// The number of recorded values
+    std::uint64_t m_count = 0;
+    /// The smallest recorded value
+    std::uint64_t m_min = 0;
+    /// The largest recorded value
+    std::uint64_t m_max = 0;
+    /// The sum of the recorded values
+    double m_sum = 0.;
+
+};  // class histogram
+
+}  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
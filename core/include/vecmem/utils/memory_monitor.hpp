@@ -10,12 +10,26 @@
 
 // Local include(s).
 #include "vecmem/memory/instrumenting_memory_resource.hpp"
+#include "vecmem/utils/histogram.hpp"
 #include "vecmem/vecmem_core_export.hpp"
 
 // System include(s).
+#include <atomic>
 #include <cstddef>
+#include <memory>
+
+// Disable the warning(s) about inheriting from/using standard library types
+// with an exported class.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif  // MSVC
 
 namespace vecmem {
+namespace details {
+struct memory_monitor_shard;
+struct memory_monitor_lifetime_slot;
+}  // namespace details
 
 /// Class collecting some basic set of memory allocation statistics
 ///
@@ -23,6 +37,21 @@ namespace vecmem {
 /// @c vecmem::instrumenting_memory_resource to easily access a common set of
 /// useful performance metrics about an application.
 ///
+/// Besides the basic counters, the monitor fills histograms of the sizes of
+/// the allocations, of the time taken by the allocations / de-allocations,
+/// and of the lifetime of the allocations. Histograms of multiple monitors
+/// can be combined using @c vecmem::histogram::merge(...).
+///
+/// The monitor can be used with a memory resource that is shared by multiple
+/// threads. The statistics are collected in per-thread shards, without any
+/// locks, and are only combined when they are read.
+///
+/// Lifetimes are only measured for a sample of the allocations: every
+/// @c lifetime_sample_rate-th allocation of a thread is tracked, as long as
+/// there is room for it in a fixed size (4096 entry) table. So with a large
+/// number of outstanding allocations, some of their lifetimes are not
+/// measured.
+///
 /// Note that the lifetime of this object must be at least as long as the
 /// lifetime of the connected memory resource!
 ///
@@ -30,7 +59,15 @@ class VECMEM_CORE_EXPORT memory_monitor {
 
 public:
     /// Constructor with a memory resource reference
-    memory_monitor(instrumenting_memory_resource& resource);
+    ///
+    /// @param resource The memory resource to monitor
+    /// @param lifetime_sample_rate Measure the lifetime of every N-th
+    ///                             allocation of a thread
+    ///
+    memory_monitor(instrumenting_memory_resource& resource,
+                   std::size_t lifetime_sample_rate = 1);
+    /// Destructor
+    ~memory_monitor();
 
     /// Get the total amount of allocations
     std::size_t total_allocation() const;
@@ -41,26 +78,47 @@ public:
     /// Get the maximal concurrent allocation
     std::size_t maximal_allocation() const;
 
+    /// Get the histogram of the (successful) allocation sizes, in bytes
+    histogram size_histogram() const;
+    /// Get the histogram of the allocation latencies, in nanoseconds
+    histogram allocation_latency_histogram() const;
+    /// Get the histogram of the de-allocation latencies, in nanoseconds
+    histogram deallocation_latency_histogram() const;
+    /// Get the histogram of the lifetimes of the allocations, in nanoseconds
+    histogram lifetime_histogram() const;
+
 private:
     /// @name Function(s) implementing the "monitor interface"
     /// @{
 
+    /// Function called before memory allocations
+    void pre_allocate(std::size_t size, std::size_t align);
     /// Function called after successful memory allocations
     void post_allocate(std::size_t size, std::size_t align, void* ptr);
     /// Function called before memory de-allocations
     void pre_deallocate(void* ptr, std::size_t size, std::size_t align);
+    /// Function called after memory de-allocations
+    void post_deallocate(void* ptr, std::size_t size, std::size_t align);
 
     /// @}
 
-    /// The number of allocations
-    std::size_t m_n_alloc = 0;
-    /// Total allocation
-    std::size_t m_total_alloc = 0;
     /// Outstanding allocation
-    std::size_t m_outstanding_alloc = 0;
+    std::atomic<std::size_t> m_outstanding_alloc{0};
     /// Maximum allocation
-    std::size_t m_maximum_alloc = 0;
+    std::atomic<std::size_t> m_maximum_alloc{0};
+
+    /// Measure the lifetime of every N-th allocation of a thread
+    const std::size_t m_lifetime_sample_rate;
+    /// The per-thread shards of the rest of the statistics
+    std::unique_ptr<details::memory_monitor_shard[]> m_shards;
+    /// The allocation times of the sampled, outstanding allocations
+    std::unique_ptr<details::memory_monitor_lifetime_slot[]> m_lifetime_slots;
 
 };  // class memory_monitor
 
 }  // namespace vecmem
+
+// Re-enable the warning(s).
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif  // MSVC
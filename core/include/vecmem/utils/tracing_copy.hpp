@@ -0,0 +1,51 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/utils/chrome_trace_writer.hpp"
+#include "vecmem/utils/copy.hpp"
+#include "vecmem/vecmem_core_export.hpp"
+
+// System include(s).
+#include <cstddef>
+
+namespace vecmem {
+
+/// Copy object writing all of its "low level" operations into a trace
+///
+/// It forwards all copy / memset operations to another copy object (for
+/// instance @c vecmem::cuda::copy), and writes every one of them, with its
+/// size, pointers and duration, into a @c vecmem::chrome_trace_writer.
+///
+/// For asynchronous copy objects the recorded durations are only those of
+/// issuing the operations.
+///
+class VECMEM_CORE_EXPORT tracing_copy : public copy {
+
+public:
+    /// Constructor with the copy object to forward to, and a trace writer
+    tracing_copy(copy& wrapped, chrome_trace_writer& writer);
+
+protected:
+    /// Perform a "low level" memory copy, and write it into the trace
+    virtual void do_copy(std::size_t size, const void* from, void* to,
+                         type::copy_type cptype) override;
+    /// Perform a "low level" memory filling operation, and trace it
+    virtual void do_memset(std::size_t size, void* ptr, int value) override;
+
+private:
+    /// The copy object performing the operations
+    copy& m_wrapped;
+    /// The writer to write the operations with
+    chrome_trace_writer& m_writer;
+
+};  // class tracing_copy
+
+}  // namespace vecmem
@@ -13,6 +13,9 @@
 
 // System include(s).
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <new>
 
 namespace vecmem::details {
 
@@ -70,77 +73,227 @@ std::size_t align_down(std::size_t value) noexcept {
     return alignment::align_down(value, allocation_alignment);
 }
 
-block first_fit(std::set<block>& free_blocks, std::size_t size) {
-    auto const iter =
-        std::find_if(free_blocks.cbegin(), free_blocks.cend(),
-                     [size](auto const& b) { return b.fits(size); });
+node_cache::~node_cache() {
 
-    if (iter == free_blocks.cend()) {
-        return {};
-    } else {
-        // remove the block from the freeList
-        auto const b = *iter;
-        auto const i = free_blocks.erase(iter);
-
-        if (b.size() > size) {
-            // split the block and put the remainder back.
-            auto const split = b.split(size);
-            free_blocks.insert(i, split.second);
-            return split.first;
-        } else {
-            // b.size == size then return b
-            return b;
+    for (std::size_t i = 0; i < free_nodes_.size(); ++i) {
+        while (free_nodes_[i] != nullptr) {
+            free_node* const n = free_nodes_[i];
+            free_nodes_[i] = n->next;
+            ::operator delete(n);
         }
     }
 }
 
-block coalesce_block(std::set<block>& free_blocks, block const& b) {
-    // return the given block in case is not valid
-    if (!b.is_valid())
-        return b;
+void* node_cache::allocate(std::size_t bytes) {
 
-    // find the right place (in ascending address order) to insert the block
-    auto const next = free_blocks.lower_bound(b);
-    auto const previous = next == free_blocks.cbegin() ? next : std::prev(next);
+    // nodes that are too large to cache come from the heap directly
+    if (bytes == 0 || bytes > max_node_size) {
+        return ::operator new(bytes);
+    }
 
-    // coalesce with neighboring blocks
-    bool const merge_prev = previous->is_contiguous_before(b);
-    bool const merge_next =
-        next != free_blocks.cend() && b.is_contiguous_before(*next);
+    // take a cached node of the right size if there is one
+    free_node*& head = free_nodes_[(bytes - 1) / node_granularity];
+    if (head != nullptr) {
+        free_node* const n = head;
+        head = n->next;
+        return n;
+    }
+
+    // otherwise allocate a node of the full size of its free list
+    return ::operator new(alignment::align_up(bytes, node_granularity));
+}
 
-    block merged{};
-    if (merge_prev && merge_next) {
-        // if can merge with prev and next neighbors
-        merged = previous->merge(b).merge(*next);
+void node_cache::deallocate(void* p, std::size_t bytes) noexcept {
 
-        free_blocks.erase(previous);
+    if (bytes == 0 || bytes > max_node_size) {
+        ::operator delete(p);
+        return;
+    }
+
+    free_node*& head = free_nodes_[(bytes - 1) / node_granularity];
+    head = new (p) free_node{head};
+}
+
+block_table::block_table() : slots_(64), log2_slots_(6) {}
+
+void block_table::insert(block const& b) {
+
+    // keep the table at most half full, for short probe sequences
+    if (2 * (size_ + 1) > slots_.size()) {
+        grow();
+    }
+
+    std::size_t const mask = slots_.size() - 1;
+    std::size_t i = home_slot(b.pointer());
+    while (slots_[i].is_valid()) {
+        i = (i + 1) & mask;
+    }
+    slots_[i] = b;
+    ++size_;
+}
+
+block block_table::erase(void* p) noexcept {
+
+    // find the slot of the block
+    std::size_t const mask = slots_.size() - 1;
+    std::size_t i = home_slot(p);
+    while (slots_[i].pointer() != p) {
+        if (!slots_[i].is_valid()) {
+            return {};
+        }
+        i = (i + 1) & mask;
+    }
+    block const found = slots_[i];
+
+    /*
+     * Shift the following blocks of the probe sequence backwards, so that
+     * no block would become unreachable from its home slot. A block at slot
+     * j can be moved into the hole at slot i, if its home slot is not
+     * (cyclically) within (i, j].
+     */
+    for (std::size_t j = (i + 1) & mask; slots_[j].is_valid();
+         j = (j + 1) & mask) {
+        std::size_t const home = home_slot(slots_[j].pointer());
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            slots_[i] = slots_[j];
+            i = j;
+        }
+    }
+    slots_[i] = {};
+    --size_;
+
+    return found;
+}
+
+std::size_t block_table::home_slot(void* p) const noexcept {
+
+    // fibonacci hashing of the pointer, whose low bits are mostly zero
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p)) *
+         0x9E3779B97F4A7C15ull) >>
+        (64 - log2_slots_));
+}
+
+void block_table::grow() {
+
+    std::vector<block> old_slots(slots_.size() * 2);
+    old_slots.swap(slots_);
+    ++log2_slots_;
+
+    std::size_t const mask = slots_.size() - 1;
+    for (block const& b : old_slots) {
+        if (b.is_valid()) {
+            std::size_t i = home_slot(b.pointer());
+            while (slots_[i].is_valid()) {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = b;
+        }
+    }
+}
+
+bool block_size_less::operator()(block const& a, block const& b) const {
+    return a.size() < b.size() ||
+           (a.size() == b.size() && a.pointer() < b.pointer());
+}
+
+free_list::free_list(node_cache& nodes)
+    : by_address_(node_allocator<block>(nodes)),
+      by_size_(node_allocator<block>(nodes)) {}
+
+void free_list::insert(block const& b) {
+    by_address_.insert(b);
+    by_size_.insert(b);
+}
+
+bool free_list::erase(block const& b) {
+    if (by_address_.erase(b) == 0) {
+        return false;
+    }
+    by_size_.erase(b);
+    return true;
+}
+
+block_set const& free_list::by_address() const {
+    return by_address_;
+}
+
+std::set<block, block_size_less, node_allocator<block>> const&
+free_list::by_size() const {
+    return by_size_;
+}
+
+block best_fit(free_list& free_blocks, std::size_t size) {
+    // the smallest block of at least `size` bytes, at the lowest address
+    // among the blocks of that size
+    auto const iter = free_blocks.by_size().lower_bound(block{nullptr, size});
 
-        auto const i = free_blocks.erase(next);
-        free_blocks.insert(i, merged);
-    } else if (merge_prev) {
-        // if only can merge with prev neighbor
-        merged = previous->merge(b);
+    if (iter == free_blocks.by_size().cend()) {
+        return {};
+    }
 
-        auto const i = free_blocks.erase(previous);
-        free_blocks.insert(i, merged);
-    } else if (merge_next) {
-        // if only can merge with next neighbor
-        merged = b.merge(*next);
+    // remove the block from the free list
+    auto const b = *iter;
+    free_blocks.erase(b);
 
-        auto const i = free_blocks.erase(next);
-        free_blocks.insert(i, merged);
+    if (b.size() > size) {
+        // split the block and put the remainder back.
+        auto const split = b.split(size);
+        free_blocks.insert(split.second);
+        return split.first;
     } else {
-        // if can't be merge with either
-        free_blocks.emplace(b);
-        merged = b;
+        // b.size == size then return b
+        return b;
     }
+}
+
+block coalesce_block(free_list& free_blocks, block_set const& superblocks,
+                     block const& b) {
+    // return the given block in case is not valid
+    if (!b.is_valid())
+        return b;
+
+    // find the right place (in ascending address order) to insert the block
+    auto const& by_address = free_blocks.by_address();
+    auto const next_it = by_address.lower_bound(b);
+    auto const prev_it =
+        next_it == by_address.cbegin() ? next_it : std::prev(next_it);
+
+    // coalesce with neighboring blocks, as long as they are in the same
+    // superblock
+    bool const merge_prev = prev_it != next_it &&
+                            prev_it->is_contiguous_before(b) &&
+                            superblocks.find(b) == superblocks.cend();
+    bool const merge_next = next_it != by_address.cend() &&
+                            b.is_contiguous_before(*next_it) &&
+                            superblocks.find(*next_it) == superblocks.cend();
+
+    // take copies of the neighbours, as erasing them invalidates the iterators
+    block const previous = merge_prev ? *prev_it : block{};
+    block const next = merge_next ? *next_it : block{};
+
+    block merged = b;
+    if (merge_prev) {
+        free_blocks.erase(previous);
+        merged = previous.merge(merged);
+    }
+    if (merge_next) {
+        free_blocks.erase(next);
+        merged = merged.merge(next);
+    }
+    free_blocks.insert(merged);
 
     return merged;
 }
 
 arena::arena(std::size_t initial_size, std::size_t maximum_size,
              memory_resource& mm)
-    : mm_(mm), size_superblocks_{initial_size}, maximum_size_{maximum_size} {
+    : mm_(mm),
+      size_superblocks_{initial_size},
+      maximum_size_{maximum_size},
+      free_blocks_(nodes_),
+      superblocks_(node_allocator<block>(nodes_)),
+      free_superblocks_(node_allocator<block>(nodes_)) {
     // assert unexpected null upstream pointer
     // assert initial arena size required to be a multiple of 256 bytes
     // assert maximum arena size required to be a multiple of 256 bytes
@@ -155,54 +308,111 @@ arena::arena(std::size_t initial_size, std::size_t maximum_size,
         }
     }
     // initial size exceeds the maxium pool size
-    this->free_blocks_.emplace(this->expand_arena(initial_size));
+    this->expand_arena(initial_size);
 }
 
 arena::~arena() {
 
-    for (auto itr = allocated_blocks_.begin();
-         itr != allocated_blocks_.end();) {
-        auto aux = itr++;
-        deallocate(aux->pointer(), aux->size());
-    }
-
-    for (auto itr = free_blocks_.begin(); itr != free_blocks_.end();) {
-        auto aux = itr++;
-        void* p = aux->pointer();
-        std::size_t size = aux->size();
-        mm_.deallocate(p, size);
+    // give all superblocks back to the upstream resource
+    for (auto const& sb : superblocks_) {
+        mm_.deallocate(sb.pointer(), sb.size());
     }
 }
 
 void* arena::allocate(std::size_t bytes) {
 
     auto const b = get_block(bytes);
-    this->allocated_blocks_.emplace(b);
+    this->allocated_blocks_.insert(b);
 
     return b.pointer();
 }
 
-bool arena::deallocate(void* p, std::size_t bytes) {
+bool arena::deallocate(void* p, std::size_t /*bytes*/) {
 
-    auto const b = free_block(p, bytes);
-    if (b.is_valid()) {
-        coalesce_block(free_blocks_, b);
+    auto const b = allocated_blocks_.erase(p);
+    if (!b.is_valid()) {
+        return false;
+    }
+
+    // check whether the superblock of the block became entirely free
+    auto const merged = coalesce_block(free_blocks_, superblocks_, b);
+    auto const sb = superblocks_.find(merged);
+    if (sb != superblocks_.end() && sb->size() == merged.size()) {
+        free_superblocks_.emplace(merged);
+        free_superblock_bytes_ += merged.size();
+        if (free_superblock_bytes_ > high_watermark_) {
+            release_unused(low_watermark_);
+        }
     }
 
-    return b.is_valid();
+    return true;
+}
+
+bool arena::owns(void const* p) const {
+    // find the last superblock starting at, or before `p`
+    auto const it = superblocks_.upper_bound(block{const_cast<void*>(p), 0});
+    if (it == superblocks_.begin()) {
+        return false;
+    }
+    auto const sb = std::prev(it);
+    return static_cast<char const*>(p) <
+           static_cast<char const*>(sb->pointer()) + sb->size();
+}
+
+std::size_t arena::release_unused(std::size_t max_retained_bytes) {
+
+    std::size_t released = 0;
+
+    // release the free superblocks from the highest address downwards
+    while (free_superblock_bytes_ > max_retained_bytes &&
+           !free_superblocks_.empty()) {
+        auto const sb = *std::prev(free_superblocks_.end());
+        free_superblocks_.erase(sb);
+        superblocks_.erase(sb);
+        free_blocks_.erase(sb);
+
+        free_superblock_bytes_ -= sb.size();
+        current_size_ -= sb.size();
+        released += sb.size();
+
+        mm_.deallocate(sb.pointer(), sb.size());
+    }
+
+    return released;
+}
+
+void arena::set_release_watermarks(std::size_t high_watermark,
+                                   std::size_t low_watermark) {
+
+    high_watermark_ = high_watermark;
+    low_watermark_ = low_watermark;
+
+    if (free_superblock_bytes_ > high_watermark_) {
+        release_unused(low_watermark_);
+    }
 }
 
 block arena::get_block(std::size_t size) {
-    if (size < minimum_superblock_size) {
-        auto const b = first_fit(this->free_blocks_, size);
-        if (b.is_valid()) {
-            return b;
-        }
+    auto const b = best_fit(this->free_blocks_, size);
+    if (b.is_valid()) {
+        use_superblock(b);
+        return b;
     }
 
-    auto const superblock = expand_arena(size);
-    coalesce_block(this->free_blocks_, superblock);
-    return first_fit(this->free_blocks_, size);
+    expand_arena(size);
+    auto const nb = best_fit(this->free_blocks_, size);
+    use_superblock(nb);
+    return nb;
+}
+
+void arena::use_superblock(block const& b) {
+    // an allocation from an entirely free superblock always starts at the
+    // beginning of the superblock
+    auto const sb = free_superblocks_.find(b);
+    if (sb != free_superblocks_.end()) {
+        free_superblock_bytes_ -= sb->size();
+        free_superblocks_.erase(sb);
+    }
 }
 
 constexpr std::size_t arena::size_to_grow(std::size_t /*size*/) const {
@@ -216,31 +426,18 @@ constexpr std::size_t arena::size_to_grow(std::size_t /*size*/) const {
 
 block arena::expand_arena(std::size_t size) {
     if (size > this->size_superblocks_)
-        size = minimum_superblock_size;
+        size = std::max(size, minimum_superblock_size);
     else {
         size = size_superblocks_;
     }
-    std::pair<std::set<block>::iterator, bool> ret =
-        free_blocks_.insert({mm_.allocate(size), size});
+    block const superblock{mm_.allocate(size), size};
+    free_blocks_.insert(superblock);
+    superblocks_.insert(superblock);
+    free_superblocks_.insert(superblock);
+    free_superblock_bytes_ += size;
 
     current_size_ += size;
-    return *(ret.first);
-}
-
-block arena::free_block(void* p, std::size_t /*size*/) noexcept {
-    auto const i =
-        std::find_if(allocated_blocks_.cbegin(), allocated_blocks_.cend(),
-                     [p](auto const& b) { return b.pointer() == p; });
-
-    if (i == this->allocated_blocks_.end()) {
-        return {};
-    }
-
-    auto const found = *i;
-
-    this->allocated_blocks_.erase(i);
-
-    return found;
+    return superblock;
 }
 
 }  // namespace vecmem::details
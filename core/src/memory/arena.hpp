@@ -12,8 +12,11 @@
 #include "vecmem/memory/memory_resource.hpp"
 
 // System include(s).
+#include <array>
+#include <cstddef>
+#include <limits>
 #include <set>
-#include <unordered_set>
+#include <vector>
 
 namespace vecmem::details {
 
@@ -83,9 +86,159 @@ std::size_t align_up(std::size_t value) noexcept;
 
 std::size_t align_down(std::size_t value) noexcept;
 
-block first_fit(std::set<block>& free_blocks, std::size_t size);
+// a cache of the nodes freed by the containers of an arena. nodes of up to
+// `max_node_size` bytes are kept in per-size free lists and are handed out
+// again, so that the containers do not go to the heap in steady state.
+class node_cache {
+public:
+    node_cache() = default;
+    node_cache(node_cache const&) = delete;
+    node_cache& operator=(node_cache const&) = delete;
+
+    // give all cached nodes back to the heap
+    ~node_cache();
+
+    // allocate a node, from the cache if possible
+    void* allocate(std::size_t bytes);
+
+    // return a node to the cache
+    void deallocate(void* p, std::size_t bytes) noexcept;
+
+private:
+    static constexpr std::size_t node_granularity = alignof(std::max_align_t);
+    static constexpr std::size_t max_node_size = 8 * node_granularity;
+
+    struct free_node {
+        free_node* next;
+    };
+
+    // the free lists, indexed by node size in units of `node_granularity`
+    std::array<free_node*, max_node_size / node_granularity> free_nodes_{};
+};  // class node_cache
+
+// standard allocator handing out the nodes of a node_cache
+template <typename T>
+class node_allocator {
+public:
+    using value_type = T;
 
-block coalesce_block(std::set<block>& free_blocks, block const& b);
+    explicit node_allocator(node_cache& cache) noexcept : cache_(&cache) {}
+
+    template <typename U>
+    node_allocator(node_allocator<U> const& other) noexcept
+        : cache_(other.cache()) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(cache_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        cache_->deallocate(p, n * sizeof(T));
+    }
+
+    // returns the cache that this allocator uses
+    node_cache* cache() const noexcept { return cache_; }
+
+    template <typename U>
+    bool operator==(node_allocator<U> const& other) const noexcept {
+        return cache_ == other.cache();
+    }
+
+    template <typename U>
+    bool operator!=(node_allocator<U> const& other) const noexcept {
+        return cache_ != other.cache();
+    }
+
+private:
+    node_cache* cache_;
+};  // class node_allocator
+
+// address-ordered set of blocks, using the nodes of a node_cache
+using block_set = std::set<block, std::less<block>, node_allocator<block>>;
+
+// open-addressing hash table of the allocated blocks of an arena, keyed by
+// their pointers. it uses linear probing with backward-shift deletion, so it
+// only needs to allocate memory when it grows.
+class block_table {
+public:
+    block_table();
+
+    // add an allocated block to the table
+    void insert(block const& b);
+
+    // find, remove and return the block starting at `p`
+    //
+    // @param[in] p the pointer of the block
+    // @return block the removed block, or an invalid block if `p` is unknown
+    block erase(void* p) noexcept;
+
+private:
+    // the preferred slot of a pointer
+    std::size_t home_slot(void* p) const noexcept;
+
+    // double the number of slots, and re-insert all blocks
+    void grow();
+
+    // the slots of the table, an invalid block marks an empty slot
+    std::vector<block> slots_;
+    // log2 of the number of slots
+    std::size_t log2_slots_{};
+    // the number of blocks in the table
+    std::size_t size_{};
+};  // class block_table
+
+// orders blocks by their size, and blocks of the same size by their address
+struct block_size_less {
+    bool operator()(block const& a, block const& b) const;
+};  // struct block_size_less
+
+// the free blocks of an arena, indexed both by address (to find the
+// neighbours of a block for coalescing) and by size (to find the best fitting
+// block for an allocation). the two indices always hold the same blocks.
+class free_list {
+public:
+    // construct an empty free list, using the nodes of `nodes`
+    explicit free_list(node_cache& nodes);
+
+    // add a block to both indices
+    void insert(block const& b);
+
+    // remove a block from both indices
+    //
+    // @return true if the block was in the free list, false otherwise
+    bool erase(block const& b);
+
+    // returns the address-ordered index of the free blocks
+    block_set const& by_address() const;
+
+    // returns the size-ordered index of the free blocks
+    std::set<block, block_size_less, node_allocator<block>> const& by_size()
+        const;
+
+private:
+    block_set by_address_;
+    std::set<block, block_size_less, node_allocator<block>> by_size_;
+};  // class free_list
+
+// find, remove and return the smallest free block that fits `size` bytes.
+// blocks larger than `size` are split, and the remainder stays in the free
+// list.
+//
+// @param[in] free_blocks the free list to allocate from
+// @param[in] size the size in bytes of the allocation
+// @return block the allocated block, or an invalid block if none fits
+block best_fit(free_list& free_blocks, std::size_t size);
+
+// coalesce a block with its free neighbours, and add it to the free list.
+// blocks are never merged across the boundaries of superblocks, so that
+// entirely free superblocks could be given back to the upstream resource.
+//
+// @param[in] free_blocks the free list of the arena
+// @param[in] superblocks the address-ordered set of superblocks
+// @param[in] b the block to return to the free list
+// @return block the (possibly merged) block now in the free list
+block coalesce_block(free_list& free_blocks, block_set const& superblocks,
+                     block const& b);
 
 class arena {
 public:
@@ -121,6 +274,28 @@ public:
     // @return if the allocation was found, false otherwise
     bool deallocate(void* p, std::size_t bytes);
 
+    // Check whether `p` points into one of the superblocks of the arena
+    //
+    // @param[in] p the pointer to check
+    // @return true if `p` is inside of a superblock, false otherwise
+    bool owns(void const* p) const;
+
+    // Release entirely free superblocks to the upstream resource
+    //
+    // @param[in] max_retained_bytes the maximal size of the entirely free
+    // superblocks to keep
+    // @return the number of bytes released
+    std::size_t release_unused(std::size_t max_retained_bytes);
+
+    // Release entirely free superblocks automatically
+    //
+    // @param[in] high_watermark the size of entirely free superblocks above
+    // which superblocks are released after a deallocation
+    // @param[in] low_watermark the size of entirely free superblocks to keep
+    // after such a release
+    void set_release_watermarks(std::size_t high_watermark,
+                                std::size_t low_watermark);
+
 private:
     // @brief Get an available memory block of at least `size` bytes.
     //
@@ -135,24 +310,34 @@ private:
     // @return block A superblock.
     block expand_arena(std::size_t size);
 
-    // Finds, frees and returns the block associated with pointer `p`.
+    // Mark the superblock that block `b` was allocated from as used, if it
+    // was entirely free until now.
     //
-    // @param[in] p The pointer to the memory to free.
-    // @param[in] size The size of the memory to free. Must be equal to the
-    // original allocation size. return The (now freed) block associated with
-    // `p`. The caller is expected to return the block to the arena.
-    block free_block(void* p, std::size_t size) noexcept;
+    // @param[in] b the newly allocated block
+    void use_superblock(block const& b);
 
     memory_resource& mm_;
+    // Nodes for the sets of the arena, declared first to outlive them
+    node_cache nodes_;
     // The size of superblocks to allocate in case of is necessarry
     std::size_t size_superblocks_{};
     // The maximum size of the arena
     std::size_t maximum_size_;
     // The current size of the arena
     std::size_t current_size_{};
-    // Address-ordered set of free blocks
-    std::set<block> free_blocks_;
-    std::set<block> allocated_blocks_;
+    // Free blocks, ordered both by address and by size
+    free_list free_blocks_;
+    // Blocks handed out by the arena, looked up by their pointers
+    block_table allocated_blocks_;
+    // Address-ordered set of the superblocks allocated from upstream
+    block_set superblocks_;
+    // Address-ordered set of the superblocks that are entirely free
+    block_set free_superblocks_;
+    // The total size of the entirely free superblocks
+    std::size_t free_superblock_bytes_{};
+    // The watermarks for releasing free superblocks automatically
+    std::size_t high_watermark_{std::numeric_limits<std::size_t>::max()};
+    std::size_t low_watermark_{std::numeric_limits<std::size_t>::max()};
 };  // class arena
 
 }  // namespace vecmem::details
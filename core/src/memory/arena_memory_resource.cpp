@@ -11,6 +11,7 @@
 
 #include "alignment.hpp"
 #include "arena.hpp"
+#include "multi_arena.hpp"
 #include "vecmem/utils/debug.hpp"
 
 namespace vecmem {
@@ -21,11 +22,42 @@ arena_memory_resource::arena_memory_resource(memory_resource& upstream,
     : m_arena(std::make_unique<details::arena>(initial_size, maximum_size,
                                                upstream)) {}
 
+arena_memory_resource::arena_memory_resource(memory_resource& upstream,
+                                             std::size_t initial_size,
+                                             std::size_t maximum_size,
+                                             std::size_t n_arenas)
+    : m_multi_arena(std::make_unique<details::multi_arena>(
+          initial_size, maximum_size, upstream, n_arenas)) {}
+
 arena_memory_resource::~arena_memory_resource() {}
 
+std::size_t arena_memory_resource::release_unused(
+    std::size_t max_retained_bytes) {
+
+    if (m_multi_arena) {
+        return m_multi_arena->release_unused(max_retained_bytes);
+    }
+    return m_arena->release_unused(max_retained_bytes);
+}
+
+void arena_memory_resource::set_release_watermarks(std::size_t high_watermark,
+                                                   std::size_t low_watermark) {
+
+    if (m_multi_arena) {
+        m_multi_arena->set_release_watermarks(high_watermark, low_watermark);
+        return;
+    }
+    m_arena->set_release_watermarks(high_watermark, low_watermark);
+}
+
 void* arena_memory_resource::do_allocate(std::size_t bytes, std::size_t) {
 
-    void* ptr = m_arena->allocate(details::align_up(bytes));
+    void* ptr = nullptr;
+    if (m_multi_arena) {
+        ptr = m_multi_arena->allocate(details::align_up(bytes));
+    } else {
+        ptr = m_arena->allocate(details::align_up(bytes));
+    }
     VECMEM_DEBUG_MSG(4, "Allocated %lu bytes at %p", bytes, ptr);
     return ptr;
 }
@@ -34,7 +66,19 @@ void arena_memory_resource::do_deallocate(void* p, std::size_t bytes,
                                           std::size_t) {
 
     VECMEM_DEBUG_MSG(4, "De-allocating memory at %p", p);
+    if (m_multi_arena) {
+        m_multi_arena->deallocate(p, details::align_up(bytes));
+        return;
+    }
     m_arena->deallocate(p, details::align_up(bytes));
 }
 
+arena_memory_resource::ownership arena_memory_resource::do_owns(
+    const void* p) const noexcept {
+
+    const bool owned = (m_multi_arena ? m_multi_arena->owns(p)
+                                      : m_arena->owns(p));
+    return (owned ? ownership::owned : ownership::not_owned);
+}
+
 }  // namespace vecmem
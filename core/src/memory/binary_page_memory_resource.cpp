@@ -10,6 +10,7 @@
 #include "vecmem/memory/binary_page_memory_resource.hpp"
 
 #include "binary_page_memory_resource_impl.hpp"
+#include "sharded_binary_page_memory_resource_impl.hpp"
 
 namespace vecmem {
 
@@ -18,18 +19,60 @@ binary_page_memory_resource::binary_page_memory_resource(
     : m_impl(std::make_unique<details::binary_page_memory_resource_impl>(
           upstream)) {}
 
+binary_page_memory_resource::binary_page_memory_resource(
+    memory_resource &upstream, std::size_t n_shards)
+    : m_sharded_impl(
+          std::make_unique<details::sharded_binary_page_memory_resource_impl>(
+              upstream, n_shards)) {}
+
 binary_page_memory_resource::~binary_page_memory_resource() {}
 
+std::size_t binary_page_memory_resource::release_unused(
+    std::size_t max_retained_bytes) {
+
+    if (m_sharded_impl) {
+        return m_sharded_impl->release_unused(max_retained_bytes);
+    }
+    return m_impl->release_unused(max_retained_bytes);
+}
+
+void binary_page_memory_resource::set_release_watermarks(
+    std::size_t high_watermark, std::size_t low_watermark) {
+
+    if (m_sharded_impl) {
+        m_sharded_impl->set_release_watermarks(high_watermark, low_watermark);
+        return;
+    }
+    m_impl->set_release_watermarks(high_watermark, low_watermark);
+}
+
 void *binary_page_memory_resource::do_allocate(std::size_t size,
                                                std::size_t align) {
 
+    if (m_sharded_impl) {
+        return m_sharded_impl->do_allocate(size, align);
+    }
     return m_impl->do_allocate(size, align);
 }
 
 void binary_page_memory_resource::do_deallocate(void *p, std::size_t size,
                                                 std::size_t align) {
 
+    if (m_sharded_impl) {
+        m_sharded_impl->do_deallocate(p, size, align);
+        return;
+    }
     m_impl->do_deallocate(p, size, align);
 }
 
+binary_page_memory_resource::ownership binary_page_memory_resource::do_owns(
+    const void *p) const noexcept {
+
+    const bool owned =
+        (m_sharded_impl ? m_sharded_impl->owns(p)
+                        : (m_impl->find_superpage(const_cast<void *>(p)) !=
+                           nullptr));
+    return (owned ? ownership::owned : ownership::not_owned);
+}
+
 }  // namespace vecmem
@@ -9,47 +9,31 @@
 // Local include(s).
 #include "binary_page_memory_resource_impl.hpp"
 
+#include "../utils/bit_scan.hpp"
 #include "vecmem/utils/debug.hpp"
 
 // System include(s).
 #include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 
-#ifdef VECMEM_HAVE_LZCNT_U64
-#include <intrin.h>
-#endif
-
 namespace {
+using vecmem::details::clzl;
+
 /**
  * @brief Rounds a size up to the nearest power of two, and returns the power
  * (not the size itself).
  */
 std::size_t round_up(std::size_t size) {
-    for (std::size_t i = 0; i < 32; i++) {
-        if ((static_cast<std::size_t>(1UL) << i) >= size) {
-            return i;
-        }
+    if (size <= 1) {
+        return 0;
     }
 
-    return 0;
-}
-
-inline std::size_t clzl(std::size_t i) {
-#if defined(VECMEM_HAVE_LZCNT_U64)
-    return _lzcnt_u64(i);
-#elif defined(VECMEM_HAVE_BUILTIN_CLZL)
-    return __builtin_clzl(i);
-#else
-    std::size_t b;
-    for (b = 0;
-         !((i << b) & (static_cast<std::size_t>(1UL)
-                       << (std::numeric_limits<std::size_t>::digits - 1UL)));
-         ++b)
-        ;
-    return b;
-#endif
+    return std::numeric_limits<std::size_t>::digits - clzl(size - 1);
 }
 }  // namespace
 
@@ -95,16 +79,19 @@ void *binary_page_memory_resource_impl::do_allocate(std::size_t size,
     }
 
     /*
-     * If the page is split (but its children are all free), we will first
-     * need to unsplit it.
+     * Keep splitting the page until we have reached our target size.
      */
-    if (cand->get_state() == page_state::SPLIT) {
-        cand->unsplit();
-    }
+    superpage &sp = cand->get_superpage();
+    const std::size_t found = cand->get_size();
 
     /*
-     * Keep splitting the page until we have reached our target size.
+     * If we are about to use the root page of a superpage, the superpage is
+     * no longer fully vacant.
      */
+    if (cand->is_root()) {
+        m_vacant_superpage_bytes -= static_cast<std::size_t>(1UL) << found;
+    }
+
     while (cand->get_size() > goal) {
         cand->split();
         cand = cand->left_child();
@@ -113,9 +100,17 @@ void *binary_page_memory_resource_impl::do_allocate(std::size_t size,
     /*
      * Mark the page as occupied, then return the address.
      */
-
     cand->change_state_vacant_to_occupied();
 
+    /*
+     * All page sizes between our goal and the size of the page that we found
+     * may have changed their number of vacant pages, so the index needs to be
+     * updated for them.
+     */
+    for (std::size_t i = goal; i <= found; ++i) {
+        update_free_index(sp, i);
+    }
+
     /*
      * Get the address of the resulting page.
      */
@@ -131,111 +126,173 @@ void binary_page_memory_resource_impl::do_deallocate(void *p, std::size_t s,
     VECMEM_DEBUG_MSG(2, "De-allocating memory at %p", p);
 
     /*
-     * First, we will try to find the superpage in which our allocation exists,
-     * which will significantly shrink our search space.
+     * First, we will find the superpage in which our allocation exists, which
+     * will significantly shrink our search space.
      */
-    std::optional<std::reference_wrapper<superpage>> sp{};
+    superpage *sp = find_superpage(p);
 
     /*
-     * We iterate over each superpage, checking whether it is possible for that
-     * superpage to contain the allocation.
+     * For debug builds, throw an assertion error if we do not know this
+     * allocation. Otherwise just ignore it.
      */
-    for (superpage &_sp : m_superpages) {
-        /*
-         * Check whether the pointer we have lies somewhere between the begin
-         * and the end of the memory allocated by this superpage. If it does,
-         * we have found our target superpage and we can return.
-         */
-        if (_sp.m_memory.get() <= p &&
-            static_cast<void *>(_sp.m_memory.get() +
-                                (static_cast<std::size_t>(1UL) << _sp.m_size)) >
-                p) {
-            sp = _sp;
-            break;
-        }
+    assert(sp != nullptr);
+    if (sp == nullptr) {
+        return;
     }
 
     /*
      * Next, we find where in this superpage the allocation must exist; we
-     * first calculate the log_2 of the allocation size (`goal`). Then we find
-     * the number of the first page with that size (`p_min`). If we then take
-     * the pointer offset between the deallocation pointer (`p`) and the start
-     * of the superpage's memory space we arrive at an offset of `diff` bytes.
+     * first calculate the log_2 of the allocation size (`goal`). The first
+     * page with that size (`p_min`) is the leftmost page at a depth of
+     * `sp->m_size - goal` in the page tree. If we then take the pointer
+     * offset between the deallocation pointer (`p`) and the start of the
+     * superpage's memory space we arrive at an offset of `diff` bytes.
      * Dividing `diff` by the size of the page in which we will have allocated
      * the memory gives us the offset from the first page of that size, which
      * allows us to easily find the page we're looking for.
      */
     std::size_t goal = std::max(min_page_size, round_up(s));
-    std::size_t p_min = 0;
-    for (; page_ref(sp->get(), p_min).get_size() > goal; p_min = 2 * p_min + 1)
-        ;
-    std::ptrdiff_t diff =
-        static_cast<std::byte *>(p) - sp->get().m_memory.get();
+    std::size_t p_min = (static_cast<std::size_t>(1UL) << (sp->m_size - goal)) -
+                        static_cast<std::size_t>(1UL);
+    std::ptrdiff_t diff = static_cast<std::byte *>(p) - sp->m_memory.get();
+
+    /*
+     * Change the state of the page to vacant.
+     */
+    page_ref pr(*sp, p_min + (diff / (static_cast<std::size_t>(1UL) << goal)));
+    pr.change_state_occupied_to_vacant();
+
+    /*
+     * Then merge the page with its buddy for as long as the buddy is vacant
+     * as well, so that freed memory becomes available for larger requests
+     * again.
+     */
+    while (!pr.is_root() && pr.buddy().get_state() == page_state::VACANT) {
+        pr = pr.parent();
+        pr.unsplit();
+    }
+
+    /*
+     * Update the free page index for all page sizes that were touched.
+     */
+    for (std::size_t i = goal; i <= pr.get_size(); ++i) {
+        update_free_index(*sp, i);
+    }
 
     /*
-     * Finally, change the state of the page to vacant.
+     * If the whole superpage became vacant, it may be time to give some
+     * memory back to the upstream resource.
      */
-    page_ref(*sp, p_min + (diff / (static_cast<std::size_t>(1UL) << goal)))
-        .change_state_occupied_to_vacant();
+    if (pr.is_root()) {
+        m_vacant_superpage_bytes += static_cast<std::size_t>(1UL)
+                                    << sp->m_size;
+        if (m_vacant_superpage_bytes > m_high_watermark) {
+            release_unused(m_low_watermark);
+        }
+    }
 }
 
-std::optional<binary_page_memory_resource_impl::page_ref>
-binary_page_memory_resource_impl::find_free_page(std::size_t size) {
-    bool candidate_sp_found;
+std::size_t binary_page_memory_resource_impl::release_unused(
+    std::size_t max_retained_bytes) {
+    std::size_t released = 0;
 
     /*
-     * We will look for a free page by looking at all the pages of the exact
-     * size we need, and we will only move to a bigger page size if none of the
-     * superpages has a page of the right size.
+     * Walk the superpages from the newest to the oldest, releasing the fully
+     * vacant ones, until we are under the requested limit.
      */
-    do {
+    for (std::size_t i = m_superpages.size();
+         i > 0 && m_vacant_superpage_bytes > max_retained_bytes; --i) {
+        superpage &sp = *(m_superpages[i - 1]);
+        if (sp.get_state(0) != page_state::VACANT) {
+            continue;
+        }
+
         /*
-         * This will be our stopping condition; we'll keep track of whether any
-         * of the superpages even has a page of the right size; if not, we're
-         * stuck.
+         * Remove the superpage from all the indices, and then destroy it,
+         * which gives its memory back to the upstream resource.
          */
-        candidate_sp_found = false;
-
-        for (superpage &sp : m_superpages) {
-            /*
-             * For each superpage, we check if the total size is enougn to
-             * support the page size we're looking for. If not, we will never
-             * find such a page in this superpage.
-             */
-            if (size <= sp.m_size) {
-                candidate_sp_found = true;
-
-                /*
-                 * Calculate the index range of pages, from i to j, in which we
-                 * can possibly find pages of the correct size.
-                 */
-                std::size_t i = 0;
-                for (; page_ref(sp, i).get_size() > size; i = 2 * i + 1)
-                    ;
-                std::size_t j = 2 * i + 1;
-
-                /*
-                 * Iterate over the index range; if we find a free page, we
-                 * know that we're done!
-                 */
-                for (std::size_t p = i; p < j; ++p) {
-                    page_ref pr(sp, p);
-
-                    /*
-                     * Return the page, exiting the loop.
-                     */
-                    if (pr.get_state() == page_state::VACANT) {
-                        return pr;
-                    }
-                }
-            }
+        const std::size_t bytes = static_cast<std::size_t>(1UL) << sp.m_size;
+        m_free_superpages[sp.m_size].erase(&sp);
+        m_superpage_addresses.erase(sp.m_memory.get());
+        m_superpages.erase(m_superpages.begin() +
+                           static_cast<std::ptrdiff_t>(i - 1));
+
+        VECMEM_DEBUG_MSG(3, "Released a superpage of %lu bytes upstream",
+                         bytes);
+
+        m_vacant_superpage_bytes -= bytes;
+        released += bytes;
+    }
+
+    return released;
+}
+
+void binary_page_memory_resource_impl::set_release_watermarks(
+    std::size_t high_watermark, std::size_t low_watermark) {
+    m_high_watermark = high_watermark;
+    m_low_watermark = low_watermark;
+
+    if (m_vacant_superpage_bytes > m_high_watermark) {
+        release_unused(m_low_watermark);
+    }
+}
+
+binary_page_memory_resource_impl::superpage *
+binary_page_memory_resource_impl::find_superpage(void *p) {
+    /*
+     * Find the first superpage that starts after the pointer. The superpage
+     * just before it is the only one that could contain the pointer.
+     */
+    auto it = m_superpage_addresses.upper_bound(static_cast<std::byte *>(p));
+
+    if (it == m_superpage_addresses.begin()) {
+        return nullptr;
+    }
+
+    superpage *sp = std::prev(it)->second;
+
+    /*
+     * Check whether the pointer lies before the end of the memory allocated
+     * by this superpage.
+     */
+    if (static_cast<std::byte *>(p) >=
+        sp->m_memory.get() + (static_cast<std::size_t>(1UL) << sp->m_size)) {
+        return nullptr;
+    }
+
+    return sp;
+}
+
+std::optional<binary_page_memory_resource_impl::page_ref>
+binary_page_memory_resource_impl::find_free_page(std::size_t size) {
+    /*
+     * We will look for a free page in the index of vacant pages of the exact
+     * size we need, and we will only move to a bigger page size if no
+     * superpage has a vacant page of the right size.
+     */
+    for (; size < m_free_superpages.size(); ++size) {
+        if (m_free_superpages[size].empty()) {
+            continue;
         }
 
         /*
-         * If we find nothing, look for a page twice as big.
+         * This superpage is guaranteed to have a vacant page of the correct
+         * size. Calculate the index range of pages, from i to j, in which the
+         * page must be.
          */
-        size++;
-    } while (candidate_sp_found);
+        superpage &sp = **(m_free_superpages[size].begin());
+        std::size_t i = (static_cast<std::size_t>(1UL) << (sp.m_size - size)) -
+                        static_cast<std::size_t>(1UL);
+        std::size_t j = 2 * i + 1;
+
+        /*
+         * Scan the index range, and return the first vacant page.
+         */
+        std::optional<std::size_t> p = sp.find_vacant_page(i, j);
+        if (p) {
+            return page_ref(sp, *p);
+        }
+    }
 
     /*
      * If we really can't find a fitting page, we return nothing.
@@ -243,73 +300,183 @@ binary_page_memory_resource_impl::find_free_page(std::size_t size) {
     return {};
 }
 
+void binary_page_memory_resource_impl::update_free_index(superpage &sp,
+                                                         std::size_t size) {
+    if (sp.vacant_pages(size) > 0) {
+        m_free_superpages[size].insert(&sp);
+    } else {
+        m_free_superpages[size].erase(&sp);
+    }
+}
+
 void binary_page_memory_resource_impl::allocate_upstream(std::size_t size) {
     /*
      * Add our new page to the list of root pages.
      */
-    m_superpages.emplace_back(std::max(size, new_page_size), m_upstream);
+    m_superpages.push_back(
+        std::make_unique<superpage>(std::max(size, new_page_size), m_upstream));
+    superpage &sp = *(m_superpages.back());
+    m_superpage_addresses.emplace(sp.m_memory.get(), &sp);
+    m_vacant_superpage_bytes += static_cast<std::size_t>(1UL) << sp.m_size;
+
+    /*
+     * Make sure that the index can hold pages of this size, and record the
+     * new (vacant) root page in it.
+     */
+    if (m_free_superpages.size() <= sp.m_size) {
+        m_free_superpages.resize(sp.m_size + 1);
+    }
+    update_free_index(sp, sp.m_size);
 }
 
 binary_page_memory_resource_impl::superpage::superpage(
     std::size_t size, memory_resource &resource)
     : m_size(size),
       m_num_pages((2UL << (m_size - min_page_size)) - 1),
-      m_pages(std::make_unique<page_state[]>(m_num_pages)),
+      m_pages(std::make_unique<std::uint64_t[]>(
+          (m_num_pages + pages_per_word - 1) / pages_per_word)),
+      m_vacant_pages(
+          std::make_unique<std::size_t[]>(m_size - min_page_size + 1)),
       m_memory(make_unique_alloc<std::byte[]>(
           resource, static_cast<std::size_t>(1UL) << m_size)) {
     /*
-     * Set all pages as non-extant, except the first one.
+     * Set all pages as non-extant, except the first one. All bits set
+     * corresponds to the non-extant state.
      */
-    for (std::size_t i = 0; i < m_num_pages; ++i) {
-        if (i == 0) {
-            m_pages[i] = page_state::VACANT;
-        } else {
-            m_pages[i] = page_state::NON_EXTANT;
-        }
-    }
+    const std::size_t n_words =
+        (m_num_pages + pages_per_word - 1) / pages_per_word;
+    std::fill(m_pages.get(), m_pages.get() + n_words,
+              ~static_cast<std::uint64_t>(0UL));
+    set_state(0, page_state::VACANT);
+
+    /*
+     * Which means that the only vacant page is the root page.
+     */
+    m_vacant_pages[0] = 1;
 }
 
 std::size_t binary_page_memory_resource_impl::superpage::total_pages() const {
     return m_num_pages;
 }
 
+std::size_t binary_page_memory_resource_impl::superpage::vacant_pages(
+    std::size_t size) const {
+    if (size > m_size || size < min_page_size) {
+        return 0;
+    }
+
+    return m_vacant_pages[m_size - size];
+}
+
+binary_page_memory_resource_impl::page_state
+binary_page_memory_resource_impl::superpage::get_state(std::size_t i) const {
+    const std::size_t shift = page_state_bits * (i % pages_per_word);
+    return static_cast<page_state>((m_pages[i / pages_per_word] >> shift) &
+                                   static_cast<std::uint64_t>(3UL));
+}
+
+void binary_page_memory_resource_impl::superpage::set_state(std::size_t i,
+                                                           page_state s) {
+    const std::size_t shift = page_state_bits * (i % pages_per_word);
+    std::uint64_t &word = m_pages[i / pages_per_word];
+    word = (word & ~(static_cast<std::uint64_t>(3UL) << shift)) |
+           (static_cast<std::uint64_t>(s) << shift);
+}
+
+std::optional<std::size_t>
+binary_page_memory_resource_impl::superpage::find_vacant_page(
+    std::size_t begin, std::size_t end) const {
+    /*
+     * Mask selecting the low bit of every page state in a word.
+     */
+    static constexpr std::uint64_t low_bits = 0x5555555555555555ULL;
+
+    for (std::size_t w = begin / pages_per_word; w * pages_per_word < end;
+         ++w) {
+        /*
+         * A page is vacant if the low bit of its state is set, but the high
+         * bit is not. Compute a mask of these pages for the entire word.
+         */
+        const std::uint64_t word = m_pages[w];
+        std::uint64_t vacant = word & ~(word >> 1) & low_bits;
+
+        /*
+         * Mask out the pages that are outside of the requested range.
+         */
+        const std::size_t first = w * pages_per_word;
+        if (begin > first) {
+            vacant &= ~static_cast<std::uint64_t>(0UL)
+                      << (page_state_bits * (begin - first));
+        }
+        if (end < first + pages_per_word) {
+            vacant &= ~(~static_cast<std::uint64_t>(0UL)
+                        << (page_state_bits * (end - first)));
+        }
+
+        /*
+         * If there is any vacant page left, return the lowest one.
+         */
+        if (vacant != 0) {
+            const std::uint64_t lowest = vacant & (~vacant + 1);
+            const std::size_t bit = (std::numeric_limits<std::size_t>::digits -
+                                     1) -
+                                    clzl(static_cast<std::size_t>(lowest));
+            return first + bit / page_state_bits;
+        }
+    }
+
+    return {};
+}
+
+std::size_t binary_page_memory_resource_impl::page_ref::get_depth() const {
+    /*
+     * The depth of a page is the (floored) log_2 of its index plus one.
+     */
+    return (std::numeric_limits<std::size_t>::digits - 1) - clzl(m_page + 1);
+}
+
 std::size_t binary_page_memory_resource_impl::page_ref::get_size() const {
     /*
-     * Calculate the size of allocation represented by this page.
+     * Calculate the size of allocation represented by this page. Every level
+     * in the tree halves the size of the pages.
      */
-    return (min_page_size -
-            ((8 * sizeof(std::size_t) - 1) - clzl(m_page + 1))) +
-           min_page_size;
+    return m_superpage.get().m_size - get_depth();
 }
 
 void binary_page_memory_resource_impl::page_ref::
     change_state_vacant_to_occupied() {
-    m_superpage.get().m_pages[m_page] = page_state::OCCUPIED;
+    m_superpage.get().set_state(m_page, page_state::OCCUPIED);
+    --m_superpage.get().m_vacant_pages[get_depth()];
 }
 
 void binary_page_memory_resource_impl::page_ref::
     change_state_occupied_to_vacant() {
-    m_superpage.get().m_pages[m_page] = page_state::VACANT;
+    m_superpage.get().set_state(m_page, page_state::VACANT);
+    ++m_superpage.get().m_vacant_pages[get_depth()];
 }
 
 void binary_page_memory_resource_impl::page_ref::
     change_state_non_extant_to_vacant() {
-    m_superpage.get().m_pages[m_page] = page_state::VACANT;
+    m_superpage.get().set_state(m_page, page_state::VACANT);
+    ++m_superpage.get().m_vacant_pages[get_depth()];
 }
 
 void binary_page_memory_resource_impl::page_ref::
     change_state_vacant_to_non_extant() {
-    m_superpage.get().m_pages[m_page] = page_state::NON_EXTANT;
+    m_superpage.get().set_state(m_page, page_state::NON_EXTANT);
+    --m_superpage.get().m_vacant_pages[get_depth()];
 }
 
 void binary_page_memory_resource_impl::page_ref::
     change_state_vacant_to_split() {
-    m_superpage.get().m_pages[m_page] = page_state::SPLIT;
+    m_superpage.get().set_state(m_page, page_state::SPLIT);
+    --m_superpage.get().m_vacant_pages[get_depth()];
 }
 
 void binary_page_memory_resource_impl::page_ref::
     change_state_split_to_vacant() {
-    m_superpage.get().m_pages[m_page] = page_state::VACANT;
+    m_superpage.get().set_state(m_page, page_state::VACANT);
+    ++m_superpage.get().m_vacant_pages[get_depth()];
 }
 
 binary_page_memory_resource_impl::page_ref::page_ref(superpage &s,
@@ -323,23 +490,23 @@ bool binary_page_memory_resource_impl::page_ref::exists() const {
 binary_page_memory_resource_impl::page_state
 binary_page_memory_resource_impl::page_ref::get_state() const {
     if (exists()) {
-        return m_superpage.get().m_pages[m_page];
+        return m_superpage.get().get_state(m_page);
     } else {
         return page_state::NON_EXTANT;
     }
 }
 
 void *binary_page_memory_resource_impl::page_ref::get_addr() const {
-    page_ref lmn = {m_superpage, 0};
-
-    while (lmn.left_child().m_page < m_page) {
-        lmn = lmn.left_child();
-    }
+    /*
+     * The leftmost page at depth d has index 2^d - 1, so the position of this
+     * page on its level is its index minus that.
+     */
+    const std::size_t pos =
+        (m_page + 1) - (static_cast<std::size_t>(1UL) << get_depth());
 
     return static_cast<void *>(
         &m_superpage.get()
-             .m_memory[(m_page - lmn.m_page) *
-                       (static_cast<std::size_t>(1UL) << get_size())]);
+             .m_memory[pos * (static_cast<std::size_t>(1UL) << get_size())]);
 }
 
 binary_page_memory_resource_impl::page_ref
@@ -351,6 +518,28 @@ binary_page_memory_resource_impl::page_ref::right_child() const {
     return {m_superpage, 2 * m_page + 2};
 }
 
+binary_page_memory_resource_impl::page_ref
+binary_page_memory_resource_impl::page_ref::parent() const {
+    return {m_superpage, (m_page - 1) / 2};
+}
+
+binary_page_memory_resource_impl::page_ref
+binary_page_memory_resource_impl::page_ref::buddy() const {
+    /*
+     * Left children have odd indices, right children have even ones.
+     */
+    return {m_superpage, (m_page % 2 == 1) ? m_page + 1 : m_page - 1};
+}
+
+bool binary_page_memory_resource_impl::page_ref::is_root() const {
+    return m_page == 0;
+}
+
+binary_page_memory_resource_impl::superpage &
+binary_page_memory_resource_impl::page_ref::get_superpage() const {
+    return m_superpage.get();
+}
+
 void binary_page_memory_resource_impl::page_ref::unsplit() {
     if (left_child().get_state() == page_state::SPLIT) {
         left_child().unsplit();
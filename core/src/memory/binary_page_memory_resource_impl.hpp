@@ -14,9 +14,13 @@
 
 // System include(s).
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <vector>
 
 namespace vecmem::details {
@@ -50,8 +54,21 @@ struct binary_page_memory_resource_impl {
      * and used directly (thus it is not split). A VACANT page is not split
      * and unused. A SPLIT page is split in two, and has two children pages.
      * Non-extant pages do not exist, because their parent is not split.
+     *
+     * The values of the states are chosen such that they can be packed into
+     * two bits each.
      */
-    enum class page_state { OCCUPIED, VACANT, SPLIT, NON_EXTANT };
+    enum class page_state : std::uint64_t {
+        OCCUPIED = 0,
+        VACANT = 1,
+        SPLIT = 2,
+        NON_EXTANT = 3
+    };
+
+    /// The number of bits used to store the state of a single page
+    static constexpr std::size_t page_state_bits = 2;
+    /// The number of page states packed into a single word
+    static constexpr std::size_t pages_per_word = 64 / page_state_bits;
 
     /**
      * @brief Container for superpages in our buddy allocator.
@@ -71,6 +88,30 @@ struct binary_page_memory_resource_impl {
          */
         std::size_t total_pages() const;
 
+        /**
+         * @brief Return the number of vacant pages of a given size (log_2)
+         * in the superpage.
+         */
+        std::size_t vacant_pages(std::size_t) const;
+
+        /**
+         * @brief Return the state of the page with the given index.
+         */
+        page_state get_state(std::size_t) const;
+
+        /**
+         * @brief Set the state of the page with the given index.
+         */
+        void set_state(std::size_t, page_state);
+
+        /**
+         * @brief Find the first vacant page in the index range [begin, end).
+         *
+         * The page states are scanned a full word (32 pages) at a time.
+         */
+        std::optional<std::size_t> find_vacant_page(std::size_t begin,
+                                                    std::size_t end) const;
+
         /**
          * @brief Size (log_2) of the entire allocation represented by this
          * superpage.
@@ -83,10 +124,19 @@ struct binary_page_memory_resource_impl {
         std::size_t m_num_pages;
 
         /**
-         * @brief Array of pages, remembering that this always resides in
-         * host-accessible memory.
+         * @brief Packed array of page states, remembering that this always
+         * resides in host-accessible memory.
+         *
+         * The state of page @c i is stored in bits
+         * [2 * (i % 32), 2 * (i % 32) + 1] of word @c i / 32.
          */
-        std::unique_ptr<page_state[]> m_pages;
+        std::unique_ptr<std::uint64_t[]> m_pages;
+
+        /**
+         * @brief Number of vacant pages on each level of the page tree, with
+         * index 0 belonging to the root page.
+         */
+        std::unique_ptr<std::size_t[]> m_vacant_pages;
 
         /**
          * @brief The actual allocation, which is just a byte pointer. This
@@ -136,6 +186,12 @@ struct binary_page_memory_resource_impl {
          */
         bool exists() const;
 
+        /**
+         * @brief Return the depth of the page referenced in the page tree,
+         * with the root page being at depth 0.
+         */
+        std::size_t get_depth() const;
+
         /**
          * @brief Return the size (log_2) of the page referenced.
          */
@@ -158,10 +214,34 @@ struct binary_page_memory_resource_impl {
         page_ref left_child() const;
 
         /**
-         * @brief Obtain a reference to this page's left child.
+         * @brief Obtain a reference to this page's right child.
          */
         page_ref right_child() const;
 
+        /**
+         * @brief Obtain a reference to this page's parent.
+         *
+         * @note Must not be called on the root page of a superpage.
+         */
+        page_ref parent() const;
+
+        /**
+         * @brief Obtain a reference to the other child of this page's parent.
+         *
+         * @note Must not be called on the root page of a superpage.
+         */
+        page_ref buddy() const;
+
+        /**
+         * @brief Check whether this is the root page of its superpage.
+         */
+        bool is_root() const;
+
+        /**
+         * @brief Return the superpage that this page belongs to.
+         */
+        superpage &get_superpage() const;
+
         /**
          * @brief Unsplit the current page, potentially unsplitting its
          * children, too.
@@ -218,16 +298,51 @@ struct binary_page_memory_resource_impl {
 
     /// @}
 
+    /**
+     * @brief Release fully vacant superpages to the upstream resource.
+     *
+     * Superpages are released, newest first, until at most
+     * @c max_retained_bytes bytes are held in fully vacant superpages.
+     *
+     * @return The number of bytes released to the upstream resource.
+     */
+    std::size_t release_unused(std::size_t max_retained_bytes);
+
+    /**
+     * @brief Set up the automatic release of vacant superpages.
+     *
+     * Whenever a deallocation leaves more than @c high_watermark bytes in
+     * fully vacant superpages, vacant superpages are released until at most
+     * @c low_watermark bytes remain in them.
+     */
+    void set_release_watermarks(std::size_t high_watermark,
+                                std::size_t low_watermark);
+
     /**
      * @brief Find the smallest free page that could fit the requested size.
      *
-     * Note that this method might return split pages if both children are
-     * free. In that case, the page should first be unsplit. In some cases,
-     * the returned page might be (significantly) larger than the request,
-     * and should be split before allocating.
+     * The returned page is always vacant. In some cases, it might be
+     * (significantly) larger than the request, and should be split before
+     * allocating.
      */
     std::optional<page_ref> find_free_page(std::size_t);
 
+    /**
+     * @brief Find the superpage that contains the given address.
+     *
+     * Returns a null pointer if none of the superpages contain it.
+     */
+    superpage *find_superpage(void *);
+
+    /**
+     * @brief Update the free page index for one page size (log_2) of a
+     * superpage.
+     *
+     * Must be called whenever the number of vacant pages of the given size
+     * may have changed in the superpage.
+     */
+    void update_free_index(superpage &, std::size_t);
+
     /**
      * @brief Perform an upstream allocation.
      *
@@ -238,7 +353,31 @@ struct binary_page_memory_resource_impl {
     void allocate_upstream(std::size_t);
 
     memory_resource &m_upstream;
-    std::vector<superpage> m_superpages;
+    std::vector<std::unique_ptr<superpage>> m_superpages;
+
+    /**
+     * @brief Index of superpages by the start address of their memory.
+     *
+     * This allows us to find the superpage owning a pointer in logarithmic
+     * time on deallocation.
+     */
+    std::map<std::byte *, superpage *> m_superpage_addresses;
+
+    /**
+     * @brief Index of superpages with vacant pages, by page size (log_2).
+     *
+     * Element @c i of this vector holds all of the superpages that have at
+     * least one vacant page of size 2^i. This allows us to find a free page
+     * without looking at superpages that cannot provide one.
+     */
+    std::vector<std::set<superpage *>> m_free_superpages;
+
+    /// Total size of the superpages that are fully vacant
+    std::size_t m_vacant_superpage_bytes = 0;
+    /// Vacant superpage size above which superpages are released automatically
+    std::size_t m_high_watermark = std::numeric_limits<std::size_t>::max();
+    /// Vacant superpage size to go down to in automatic releases
+    std::size_t m_low_watermark = std::numeric_limits<std::size_t>::max();
 
 };  // struct binary_page_memory_resource_impl
 
@@ -0,0 +1,60 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace vecmem::details {
+
+/// Allocate memory from a block with a (thread-safe) bump pointer
+///
+/// @param next The bump pointer, pointing at the unallocated part of the
+///             block
+/// @param end The end of the block
+/// @param size The size of the allocation
+/// @param alignment The alignment of the allocation (a power of two)
+/// @return The allocated memory, or @c nullptr if the block is exhausted
+///
+inline void* bump_allocate(std::atomic<char*>& next, char* end,
+                           std::size_t size, std::size_t alignment) {
+
+    // Try to advance the bump pointer until either no other thread gets in
+    // the way, or the block is exhausted.
+    char* current = next.load(std::memory_order_relaxed);
+    while (true) {
+        // Find the next properly aligned address, and check whether the
+        // allocation would still fit.
+        const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(current);
+        const std::size_t padding =
+            ((addr + alignment - 1) & ~(alignment - 1)) - addr;
+        const std::size_t remaining = static_cast<std::size_t>(end - current);
+        if ((padding > remaining) || (remaining - padding < size)) {
+            return nullptr;
+        }
+
+        // Claim the memory, unless another thread has moved the bump pointer
+        // in the meantime. In which case the next iteration uses the updated
+        // value of @c current.
+        char* const res = current + padding;
+        if (next.compare_exchange_weak(current, res + size,
+                                       std::memory_order_relaxed)) {
+            VECMEM_DEBUG_MSG(4, "Allocated %lu bytes at %p", size,
+                             static_cast<void*>(res));
+            return res;
+        }
+    }
+}
+
+}  // namespace vecmem::details
@@ -0,0 +1,60 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/memory/caching_memory_resource.hpp"
+
+#include "caching_memory_resource_impl.hpp"
+
+namespace vecmem {
+
+caching_memory_resource::caching_memory_resource(memory_resource& upstream,
+                                                 std::size_t max_cached_bytes,
+                                                 std::size_t bin_growth,
+                                                 std::size_t min_bin_size,
+                                                 std::size_t max_bin_size)
+    : m_impl(std::make_unique<details::caching_memory_resource_impl>(
+          upstream, max_cached_bytes, bin_growth, min_bin_size,
+          max_bin_size)) {}
+
+caching_memory_resource::~caching_memory_resource() {}
+
+std::size_t caching_memory_resource::release_unused(
+    std::size_t max_retained_bytes) {
+
+    return m_impl->release_unused(max_retained_bytes);
+}
+
+std::size_t caching_memory_resource::cache_hits() const {
+
+    return m_impl->m_hits;
+}
+
+std::size_t caching_memory_resource::cache_misses() const {
+
+    return m_impl->m_misses;
+}
+
+std::size_t caching_memory_resource::cached_bytes() const {
+
+    return m_impl->m_cached_bytes;
+}
+
+void* caching_memory_resource::do_allocate(std::size_t size,
+                                           std::size_t align) {
+
+    return m_impl->do_allocate(size, align);
+}
+
+void caching_memory_resource::do_deallocate(void* p, std::size_t size,
+                                            std::size_t align) {
+
+    m_impl->do_deallocate(p, size, align);
+}
+
+}  // namespace vecmem
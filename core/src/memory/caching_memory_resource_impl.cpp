@@ -0,0 +1,143 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "caching_memory_resource_impl.hpp"
+
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <iterator>
+#include <new>
+
+namespace vecmem::details {
+
+caching_memory_resource_impl::caching_memory_resource_impl(
+    memory_resource &upstream, std::size_t max_cached_bytes,
+    std::size_t bin_growth, std::size_t min_bin_size, std::size_t max_bin_size)
+    : m_upstream(upstream),
+      m_max_cached_bytes(max_cached_bytes),
+      m_bin_growth(std::max(bin_growth, static_cast<std::size_t>(2UL))),
+      m_min_bin_size(std::max(min_bin_size, static_cast<std::size_t>(1UL))),
+      m_max_bin_size(max_bin_size) {}
+
+caching_memory_resource_impl::~caching_memory_resource_impl() {
+
+    release_unused(0);
+}
+
+void *caching_memory_resource_impl::do_allocate(std::size_t size,
+                                                std::size_t align) {
+
+    /*
+     * Pass allocations that are not to be cached on to upstream directly.
+     */
+    const std::size_t bin = bin_size(size);
+    if (bin == 0) {
+        return m_upstream.allocate(size, align);
+    }
+
+    /*
+     * Re-use the most recently freed block of the same bin, if there is one.
+     */
+    const bin_key key{bin, align};
+    auto it = m_bins.upper_bound(key);
+    if ((it != m_bins.begin()) && (std::prev(it)->first == key)) {
+        --it;
+        void *p = it->second->m_ptr;
+        m_lru.erase(it->second);
+        m_bins.erase(it);
+        m_cached_bytes -= bin;
+        ++m_hits;
+        VECMEM_DEBUG_MSG(5, "Re-using cached block of %lu bytes at %p", bin,
+                         p);
+        return p;
+    }
+
+    /*
+     * Otherwise allocate a new block from upstream. If that fails, give all
+     * cached blocks back to upstream, and try once more.
+     */
+    ++m_misses;
+    try {
+        return m_upstream.allocate(bin, align);
+    } catch (const std::bad_alloc &) {
+        VECMEM_DEBUG_MSG(2,
+                         "Upstream allocation of %lu bytes failed, retrying "
+                         "after freeing the cache",
+                         bin);
+        release_unused(0);
+        return m_upstream.allocate(bin, align);
+    }
+}
+
+void caching_memory_resource_impl::do_deallocate(void *p, std::size_t size,
+                                                 std::size_t align) {
+
+    /*
+     * Give blocks that are not to be cached, or that would not fit into the
+     * cache at all, straight back to upstream.
+     */
+    const std::size_t bin = bin_size(size);
+    if (bin == 0) {
+        m_upstream.deallocate(p, size, align);
+        return;
+    }
+    if (bin > m_max_cached_bytes) {
+        m_upstream.deallocate(p, bin, align);
+        return;
+    }
+
+    /*
+     * Make room for the block by evicting the least recently freed blocks,
+     * and then add it to the cache.
+     */
+    release_unused(m_max_cached_bytes - bin);
+    auto lru_it = m_lru.insert(m_lru.end(), cached_block{p, m_bins.end()});
+    lru_it->m_bin_entry = m_bins.emplace(bin_key{bin, align}, lru_it);
+    m_cached_bytes += bin;
+}
+
+std::size_t caching_memory_resource_impl::release_unused(
+    std::size_t max_retained_bytes) {
+
+    std::size_t released = 0;
+    while ((m_cached_bytes > max_retained_bytes) && (!m_lru.empty())) {
+        const cached_block &b = m_lru.front();
+        const bin_key key = b.m_bin_entry->first;
+        m_upstream.deallocate(b.m_ptr, key.first, key.second);
+        m_bins.erase(b.m_bin_entry);
+        m_lru.pop_front();
+        m_cached_bytes -= key.first;
+        released += key.first;
+    }
+    return released;
+}
+
+std::size_t caching_memory_resource_impl::bin_size(std::size_t size) const {
+
+    if (size > m_max_bin_size) {
+        return 0;
+    }
+
+    /*
+     * Grow the bin geometrically, but never beyond the largest bin size. (Which
+     * also stops the growth before it could overflow.)
+     */
+    std::size_t result = m_min_bin_size;
+    while (result < size) {
+        if (result > m_max_bin_size / m_bin_growth) {
+            return m_max_bin_size;
+        }
+        result *= m_bin_growth;
+    }
+    return std::min(result, m_max_bin_size);
+}
+
+}  // namespace vecmem::details
@@ -0,0 +1,103 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/memory_resource.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <list>
+#include <map>
+#include <utility>
+
+namespace vecmem::details {
+
+/**
+ * @brief The implementation of @c vecmem::caching_memory_resource
+ */
+struct caching_memory_resource_impl {
+
+    /// Constructor, on top of another memory resource
+    caching_memory_resource_impl(memory_resource &upstream,
+                                 std::size_t max_cached_bytes,
+                                 std::size_t bin_growth,
+                                 std::size_t min_bin_size,
+                                 std::size_t max_bin_size);
+
+    /// Destructor, giving all cached blocks back to upstream
+    ~caching_memory_resource_impl();
+
+    /// @name Functions implementing the @c vecmem::memory_resource interface
+    /// @{
+
+    /// Allocate a blob of memory
+    void *do_allocate(std::size_t size, std::size_t align);
+    /// De-allocate a previously allocated memory blob
+    void do_deallocate(void *p, std::size_t size, std::size_t align);
+
+    /// @}
+
+    /// Give the least recently freed blocks back to upstream
+    std::size_t release_unused(std::size_t max_retained_bytes);
+
+    /**
+     * @brief Get the size of the bin that an allocation belongs to.
+     *
+     * Bins grow geometrically from the smallest bin size, with the largest
+     * bin having exactly the configured maximal size.
+     *
+     * @return The bin size, or 0 if the allocation is not to be cached.
+     */
+    std::size_t bin_size(std::size_t size) const;
+
+    /// The key of cached blocks: their bin sizes and alignments
+    using bin_key = std::pair<std::size_t, std::size_t>;
+
+    /// Forward declaration of the type describing cached blocks
+    struct cached_block;
+    /// Type of the list of cached blocks, in least recently freed order
+    using lru_list = std::list<cached_block>;
+    /// Type of the index of the cached blocks by their bins
+    using bin_map = std::multimap<bin_key, lru_list::iterator>;
+
+    /// Description of a block in the cache
+    struct cached_block {
+        /// Pointer to the block
+        void *m_ptr;
+        /// The position of the block in the bin index
+        bin_map::iterator m_bin_entry;
+    };
+
+    /// The upstream memory resource
+    memory_resource &m_upstream;
+    /// The maximal total size of the cached blocks
+    std::size_t m_max_cached_bytes;
+    /// The factor between the sizes of consecutive bins
+    std::size_t m_bin_growth;
+    /// The size of the smallest bin
+    std::size_t m_min_bin_size;
+    /// The largest allocation size to cache
+    std::size_t m_max_bin_size;
+
+    /// The cached blocks, the least recently freed one at the front
+    lru_list m_lru;
+    /// The cached blocks, indexed by their bins
+    bin_map m_bins;
+    /// The total size of the cached blocks
+    std::size_t m_cached_bytes = 0;
+
+    /// The number of allocations served from the cache
+    std::size_t m_hits = 0;
+    /// The number of cacheable allocations that went to upstream
+    std::size_t m_misses = 0;
+
+};  // struct caching_memory_resource_impl
+
+}  // namespace vecmem::details
@@ -8,6 +8,7 @@
 
 #include "vecmem/memory/choice_memory_resource.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <vector>
@@ -19,17 +20,48 @@ choice_memory_resource::choice_memory_resource(
     std::function<memory_resource &(std::size_t, std::size_t)> decision)
     : m_decision(decision) {}
 
+memory_resource *choice_memory_resource::find_owner(const void *p) const {
+
+    for (const auto &upstream : m_upstreams) {
+        if ((upstream.second != nullptr) &&
+            (upstream.second->owns(p) ==
+             details::memory_resource_base::ownership::owned)) {
+            return upstream.first;
+        }
+    }
+    return nullptr;
+}
+
 void *choice_memory_resource::do_allocate(std::size_t size, std::size_t align) {
     /*
-     * We cannot blindly allocate, because we need to keep track of which
-     * upstream allocator allocated this memory. Thus, we must also store
-     * the allocation result in a map.
+     * We cannot blindly allocate, because we need to be able to tell which
+     * upstream allocator allocated this memory.
      */
     memory_resource &res = m_decision(size, align);
 
+    /*
+     * Remember every upstream resource that the decision function picks.
+     * There are only ever a handful of them.
+     */
+    auto it = std::find_if(m_upstreams.begin(), m_upstreams.end(),
+                           [&res](const auto &upstream) {
+                               return upstream.first == &res;
+                           });
+    if (it == m_upstreams.end()) {
+        m_upstreams.emplace_back(
+            &res, dynamic_cast<const details::memory_resource_base *>(&res));
+    }
+
     void *ptr = res.allocate(size, align);
 
-    m_allocations.emplace(ptr, res);
+    /*
+     * Only store the allocation result in a map if the de-allocation could
+     * not be routed back to the upstream resource based on the ownership of
+     * the memory.
+     */
+    if (find_owner(ptr) != &res) {
+        m_allocations.emplace(ptr, res);
+    }
 
     return ptr;
 }
@@ -38,21 +70,28 @@ void choice_memory_resource::do_deallocate(void *ptr, std::size_t size,
                                            std::size_t align) {
     /*
      * Extract the record of which upstream resource was used to allocate the
-     * given pointer.
+     * given pointer, if there is one.
      */
-    auto nh = m_allocations.extract(ptr);
+    if (!m_allocations.empty()) {
+        auto nh = m_allocations.extract(ptr);
+        if (nh) {
+            memory_resource &res = nh.mapped();
+            res.deallocate(nh.key(), size, align);
+            return;
+        }
+    }
 
     /*
-     * For debug builds, throw an assertion error if we do not know this
-     * allocation.
+     * Otherwise find the upstream resource claiming the memory.
      */
-    assert(nh);
+    memory_resource *res = find_owner(ptr);
 
     /*
-     * Retrieve the correct resource and deallocate the memory.
+     * For debug builds, throw an assertion error if we do not know this
+     * allocation.
      */
-    memory_resource &res = nh.mapped();
+    assert(res != nullptr);
 
-    res.deallocate(nh.key(), size, align);
+    res->deallocate(ptr, size, align);
 }
 }  // namespace vecmem
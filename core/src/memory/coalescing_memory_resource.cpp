@@ -11,63 +11,164 @@
 #include <cassert>
 #include <cstddef>
 #include <initializer_list>
+#include <new>
 
+#include "../utils/bit_scan.hpp"
 #include "vecmem/memory/memory_resource.hpp"
 
+namespace {
+
+/// Get the size class of an allocation (the position of its highest bit)
+std::size_t size_class(std::size_t size) {
+
+    return ((size == 0) ? 0 : vecmem::details::highest_bit(size));
+}
+
+}  // namespace
+
 namespace vecmem {
 coalescing_memory_resource::coalescing_memory_resource(
     std::vector<std::reference_wrapper<memory_resource>> &&upstreams)
-    : m_upstreams(upstreams) {}
+    : m_upstreams(upstreams), m_failed_classes(m_upstreams.size(), 0) {
+
+    m_bases.reserve(m_upstreams.size());
+    for (memory_resource &res : m_upstreams) {
+        m_bases.push_back(dynamic_cast<details::memory_resource_base *>(&res));
+    }
+}
+
+std::size_t coalescing_memory_resource::find_owner(const void *p) const {
+
+    for (std::size_t i = 0; i < m_upstreams.size(); ++i) {
+        if ((m_bases[i] != nullptr) &&
+            (m_bases[i]->owns(p) ==
+             details::memory_resource_base::ownership::owned)) {
+            return i;
+        }
+    }
+    return m_upstreams.size();
+}
+
+void *coalescing_memory_resource::try_upstream(std::size_t i, std::size_t size,
+                                               std::size_t align) {
+    /*
+     * Use the nothrow interface of the upstream resource if it has one.
+     */
+    if (m_bases[i] != nullptr) {
+        return m_bases[i]->try_allocate(size, align);
+    }
+    try {
+        return m_upstreams[i].get().allocate(size, align);
+    } catch (std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void *coalescing_memory_resource::record(std::size_t i, void *ptr) {
+    /*
+     * Only record the allocation in the map if the de-allocation could not
+     * be routed back to this resource based on the ownership of the memory.
+     */
+    if (find_owner(ptr) != i) {
+        m_allocations.emplace(ptr, i);
+    }
+    return ptr;
+}
 
 void *coalescing_memory_resource::do_allocate(std::size_t size,
                                               std::size_t align) {
+
+    void *ptr = do_try_allocate(size, align);
+
+    /*
+     * If all resources fail to allocate, then we do as well.
+     */
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *coalescing_memory_resource::do_try_allocate(std::size_t size,
+                                                  std::size_t align) {
     /*
-     * Try to allocate with each of the upstream resources.
+     * Try to allocate with each of the upstream resources, skipping the ones
+     * that recently failed to provide memory of this size. Only the first
+     * 64 resources are ever skipped, so that a bit mask can remember which
+     * ones were.
      */
-    for (memory_resource &res : m_upstreams) {
-        try {
-            /*
-             * Try to allocate the memory, and store the result with the
-             * allocator reference in the allocation map.
-             */
-            void *ptr = res.allocate(size, align);
-
-            m_allocations.emplace(ptr, res);
-
-            return ptr;
-        } catch (std::bad_alloc &) {
-            /*
-             * If we cannot allocate with this resource, try the next one.
-             */
+    const std::uint64_t bit = std::uint64_t{1} << size_class(size);
+    std::uint64_t skipped = 0;
+    for (std::size_t i = 0; i < m_upstreams.size(); ++i) {
+        if ((i < 64) && (m_failed_classes[i] & bit)) {
+            skipped |= (std::uint64_t{1} << i);
             continue;
         }
+        void *ptr = try_upstream(i, size, align);
+        if (ptr != nullptr) {
+            return record(i, ptr);
+        }
+
+        /*
+         * If the resource could not provide memory of this size, it will not
+         * be able to provide larger blocks either.
+         */
+        m_failed_classes[i] |= ~(bit - 1);
     }
 
     /*
-     * If all resources fail to allocate, then we do as well.
+     * Memory may have been returned to the skipped resources without us
+     * knowing about it (if they are shared with other users), so give them
+     * another chance before giving up. But don't ask the ones again that
+     * just failed.
      */
-    throw std::bad_alloc();
+    if (skipped != 0) {
+        for (std::size_t i = 0; i < m_upstreams.size() && i < 64; ++i) {
+            if ((skipped & (std::uint64_t{1} << i)) == 0) {
+                continue;
+            }
+            void *ptr = try_upstream(i, size, align);
+            if (ptr != nullptr) {
+                m_failed_classes[i] = 0;
+                return record(i, ptr);
+            }
+        }
+    }
+
+    return nullptr;
 }
 
 void coalescing_memory_resource::do_deallocate(void *ptr, std::size_t size,
                                                std::size_t align) {
     /*
-     * Fetch the resource used to allocate this pointer.
+     * Allocations that could not be routed by ownership are in the map.
+     * Otherwise forward the deallocation request to the first upstream
+     * resource claiming the memory.
      */
-    auto nh = m_allocations.extract(ptr);
+    std::size_t i = m_upstreams.size();
+    if (!m_allocations.empty()) {
+        auto it = m_allocations.find(ptr);
+        if (it != m_allocations.end()) {
+            i = it->second;
+            m_allocations.erase(it);
+        }
+    }
+    if (i == m_upstreams.size()) {
+        i = find_owner(ptr);
+    }
 
     /*
      * For debug builds, throw an assertion error if we do not know this
      * allocation.
      */
-    assert(nh);
+    assert(i < m_upstreams.size());
+
+    m_upstreams[i].get().deallocate(ptr, size, align);
 
     /*
-     * If we know who allocated this memory, forward the deallocation request
-     * to them.
+     * The resource may be able to satisfy allocations again that it failed
+     * to before.
      */
-    memory_resource &res = nh.mapped();
-
-    res.deallocate(nh.key(), size, align);
+    m_failed_classes[i] = 0;
 }
 }  // namespace vecmem
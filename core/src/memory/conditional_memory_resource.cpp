@@ -29,6 +29,19 @@ void *conditional_memory_resource::do_allocate(std::size_t size,
     }
 }
 
+void *conditional_memory_resource::do_try_allocate(std::size_t size,
+                                                   std::size_t align) {
+    /*
+     * Refuse the allocation without an exception if the predicate is false,
+     * and ask the upstream resource not to throw one either otherwise.
+     */
+    if (m_pred(size, align)) {
+        return details::try_allocate(m_upstream, size, align);
+    } else {
+        return nullptr;
+    }
+}
+
 void conditional_memory_resource::do_deallocate(void *ptr, std::size_t size,
                                                 std::size_t align) {
     /*
@@ -9,65 +9,136 @@
 // Local include(s).
 #include "vecmem/memory/contiguous_memory_resource.hpp"
 
+#include "bump_allocate.hpp"
 #include "vecmem/utils/debug.hpp"
 
 // System include(s).
-#include <memory>
+#include <algorithm>
+#include <new>
 #include <stdexcept>
 
 namespace vecmem {
 
 contiguous_memory_resource::contiguous_memory_resource(
     memory_resource &upstream, std::size_t size)
+    : m_upstream(upstream), m_growth_factor(0) {
+
+    m_first = add_chunk(size);
+    m_current.store(m_first, std::memory_order_release);
+}
+
+contiguous_memory_resource::contiguous_memory_resource(
+    memory_resource &upstream, std::size_t size, std::size_t growth_factor)
     : m_upstream(upstream),
-      m_size(size),
-      m_begin(m_upstream.allocate(m_size)),
-      m_next(m_begin) {
+      m_growth_factor(
+          std::max(growth_factor, static_cast<std::size_t>(1UL))) {
 
-    VECMEM_DEBUG_MSG(
-        2, "Allocated %lu bytes at %p from the upstream memory resource",
-        m_size, m_begin);
+    m_first = add_chunk(size);
+    m_current.store(m_first, std::memory_order_release);
 }
 
 contiguous_memory_resource::~contiguous_memory_resource() {
     /*
-     * Deallocate our memory arena upstream.
+     * Deallocate our memory chunks upstream.
      */
-    m_upstream.deallocate(m_begin, m_size);
-    VECMEM_DEBUG_MSG(
-        2, "De-allocated %lu bytes at %p using the upstream memory resource",
-        m_size, m_begin);
+    for (const std::unique_ptr<chunk> &c : m_chunks) {
+        m_upstream.deallocate(c->m_begin, c->m_size);
+        VECMEM_DEBUG_MSG(
+            2,
+            "De-allocated %lu bytes at %p using the upstream memory resource",
+            c->m_size, static_cast<void *>(c->m_begin));
+    }
 }
 
-void *contiguous_memory_resource::do_allocate(std::size_t size,
-                                              std::size_t alignment) {
+contiguous_memory_resource::marker contiguous_memory_resource::mark() const {
+
+    const chunk *c = m_current.load(std::memory_order_acquire);
+    return {c->m_index,
+            static_cast<std::size_t>(c->m_next.load(std::memory_order_relaxed) -
+                                     c->m_begin)};
+}
+
+void contiguous_memory_resource::rewind(marker m) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /*
+     * Markers taken before a reset() may refer to chunks that no longer
+     * exist.
+     */
+    if ((m.m_chunk >= m_chunks.size()) ||
+        (m.m_offset > m_chunks[m.m_chunk]->m_size)) {
+        throw std::invalid_argument(
+            "Marker does not point into the contiguous memory resource");
+    }
+    chunk *c = m_chunks[m.m_chunk].get();
+    c->m_next.store(c->m_begin + m.m_offset, std::memory_order_relaxed);
+    m_current.store(c, std::memory_order_release);
+    VECMEM_DEBUG_MSG(4, "Rewound to offset %lu of chunk %lu", m.m_offset,
+                     m.m_chunk);
+}
+
+void contiguous_memory_resource::reset() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     /*
-     * Compute the remaining space, which needs to be an lvalue for standard
-     * library-related reasons.
+     * Give all chunks but the first one back to upstream. Since no other
+     * thread may be using the resource at this point, the bookkeeping of
+     * the released chunks can be deleted right away.
      */
-    std::size_t rem =
-        m_size - (static_cast<char *>(m_next) - static_cast<char *>(m_begin));
+    release_chunks(1);
+    m_retired.clear();
 
     /*
-     * Employ std::align to find the next properly aligned address.
+     * Start allocating from the beginning of the first chunk again.
      */
-    if (std::align(alignment, size, m_next, rem)) {
+    m_first->m_next.store(m_first->m_begin, std::memory_order_relaxed);
+    m_current.store(m_first, std::memory_order_release);
+}
+
+void *contiguous_memory_resource::do_allocate(std::size_t size,
+                                              std::size_t alignment) {
+
+    while (true) {
+        chunk *c = m_current.load(std::memory_order_acquire);
+        void *res = details::bump_allocate(c->m_next, c->m_begin + c->m_size,
+                                           size, alignment);
+        if (res != nullptr) {
+            return res;
+        }
+
         /*
-         * Store the return pointer, update the stored next pointer, then
-         * return.
+         * Move on to a new chunk, or throw an exception if that is not
+         * possible.
          */
-        void *res = m_next;
-        m_next = static_cast<char *>(m_next) + size;
+        next_chunk(c, size, alignment);
+    }
+}
 
-        VECMEM_DEBUG_MSG(4, "Allocated %lu bytes at %p", size, res);
+void *contiguous_memory_resource::do_try_allocate(std::size_t size,
+                                                  std::size_t alignment) {
+
+    while (true) {
+        chunk *c = m_current.load(std::memory_order_acquire);
+        void *res = details::bump_allocate(c->m_next, c->m_begin + c->m_size,
+                                           size, alignment);
+        if (res != nullptr) {
+            return res;
+        }
 
-        return res;
-    } else {
         /*
-         * If std::align returns a false-like value, the allocation has failed
-         * and we throw an exception.
+         * A fixed size resource only ever has a single chunk, so once that
+         * is exhausted, the allocation fails without an exception.
          */
-        throw std::bad_alloc();
+        if (m_growth_factor == 0) {
+            return nullptr;
+        }
+        try {
+            next_chunk(c, size, alignment);
+        } catch (const std::bad_alloc &) {
+            return nullptr;
+        }
     }
 }
 
@@ -79,4 +150,112 @@ void contiguous_memory_resource::do_deallocate(void *, std::size_t,
     return;
 }
 
+contiguous_memory_resource::ownership contiguous_memory_resource::do_owns(
+    const void *p) const noexcept {
+
+    /*
+     * There are only ever a handful of chunks, so just check all of them.
+     * The chunks are walked through their links, without taking the lock,
+     * as this is called for every allocation and de-allocation by some
+     * downstream resources. The range of a chunk never changes once it is
+     * linked in, and unlinked chunks are kept alive until the next reset().
+     */
+    const char *ptr = static_cast<const char *>(p);
+    for (const chunk *c = m_first; c != nullptr;
+         c = c->m_following.load(std::memory_order_acquire)) {
+        if ((ptr >= c->m_begin) && (ptr < c->m_begin + c->m_size)) {
+            return ownership::owned;
+        }
+    }
+    return ownership::not_owned;
+}
+
+contiguous_memory_resource::chunk *contiguous_memory_resource::add_chunk(
+    std::size_t size) {
+
+    auto c = std::make_unique<chunk>();
+    c->m_index = m_chunks.size();
+    c->m_begin = static_cast<char *>(m_upstream.allocate(size));
+    c->m_size = size;
+    c->m_next.store(c->m_begin, std::memory_order_relaxed);
+    VECMEM_DEBUG_MSG(
+        2, "Allocated %lu bytes at %p from the upstream memory resource",
+        size, static_cast<void *>(c->m_begin));
+
+    /*
+     * Publish the new chunk to do_owns(...) only once it is fully set up.
+     */
+    chunk *result = c.get();
+    if (!m_chunks.empty()) {
+        m_chunks.back()->m_following.store(result, std::memory_order_release);
+    }
+    m_chunks.push_back(std::move(c));
+    return result;
+}
+
+void contiguous_memory_resource::release_chunks(std::size_t index) {
+
+    if (index >= m_chunks.size()) {
+        return;
+    }
+
+    /*
+     * Unlink the chunks first, and only then give their memory back. The
+     * chunk objects themselves are retired instead of deleted, as
+     * do_owns(...) may be looking at them from another thread.
+     */
+    m_chunks[index - 1]->m_following.store(nullptr, std::memory_order_release);
+    for (std::size_t i = index; i < m_chunks.size(); ++i) {
+        const chunk &c = *(m_chunks[i]);
+        m_upstream.deallocate(c.m_begin, c.m_size);
+        VECMEM_DEBUG_MSG(
+            2,
+            "De-allocated %lu bytes at %p using the upstream memory resource",
+            c.m_size, static_cast<void *>(c.m_begin));
+        m_retired.push_back(std::move(m_chunks[i]));
+    }
+    m_chunks.resize(index);
+}
+
+void contiguous_memory_resource::next_chunk(chunk *exhausted,
+                                            std::size_t size,
+                                            std::size_t alignment) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /*
+     * If another thread has already moved on to a new chunk, there is
+     * nothing left to do.
+     */
+    if (m_current.load(std::memory_order_relaxed) != exhausted) {
+        return;
+    }
+
+    /*
+     * If the memory resource can not grow, the allocation has failed and we
+     * throw an exception.
+     */
+    if (m_growth_factor == 0) {
+        throw std::bad_alloc();
+    }
+
+    /*
+     * Re-use the chunk following the exhausted one if it was kept during a
+     * rewind, and it is large enough. Otherwise give it (and all chunks after
+     * it) back to upstream, and allocate a larger one.
+     */
+    const std::size_t min_size = size + alignment - 1;
+    const std::size_t index = exhausted->m_index + 1;
+    if ((index < m_chunks.size()) && (m_chunks[index]->m_size >= min_size)) {
+        chunk *c = m_chunks[index].get();
+        c->m_next.store(c->m_begin, std::memory_order_relaxed);
+        m_current.store(c, std::memory_order_release);
+        return;
+    }
+    release_chunks(index);
+    m_current.store(
+        add_chunk(std::max(exhausted->m_size * m_growth_factor, min_size)),
+        std::memory_order_release);
+}
+
 }  // namespace vecmem
@@ -8,14 +8,24 @@
 
 #include "vecmem/memory/debug_memory_resource.hpp"
 
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
 #include "vecmem/memory/memory_resource.hpp"
 
 namespace vecmem {
-debug_memory_resource::debug_memory_resource(memory_resource &upstream)
-    : m_upstream(upstream) {}
+debug_memory_resource::debug_memory_resource(memory_resource &upstream,
+                                             std::size_t sampling_rate)
+    : m_upstream(upstream),
+      m_sampling_rate(sampling_rate == 0 ? 1 : sampling_rate) {}
+
+bool debug_memory_resource::is_sampled(const void *ptr) const {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_allocations.find(const_cast<void *>(ptr));
+    return ((it != m_allocations.end()) && it->second.m_sampled);
+}
 
 void *debug_memory_resource::do_allocate(std::size_t size, std::size_t align) {
     /*
@@ -27,43 +37,69 @@ void *debug_memory_resource::do_allocate(std::size_t size, std::size_t align) {
     /*
      * Calculate the end pointer of this allocation.
      */
-    void *end = static_cast<void *>(static_cast<char *>(ptr) + size);
+    char *end = static_cast<char *>(ptr) + size;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
 
     /*
-     * Search for any potentially overlapping outstanding allocations.
+     * In sampling mode, only check every N-th allocation for overlaps. But
+     * do so against all outstanding allocations, which are all recorded.
      */
-    for (const std::pair<const void *, std::pair<std::size_t, std::size_t>> i :
-         m_allocations) {
-        const void *i_beg = i.first;
-        std::size_t i_size = i.second.first;
-        const void *i_end = static_cast<const void *>(
-            static_cast<const char *>(i_beg) + i_size);
+    const bool sampled = ((m_n_allocations++ % m_sampling_rate) == 0);
+
+    /*
+     * Search for any potentially overlapping outstanding allocations. Since
+     * the outstanding allocations should not overlap with each other, only
+     * the first one starting at or after this allocation, and the one before
+     * that, need to be checked.
+     *
+     * The record can only hold one allocation per address, so one starting
+     * at the same address is always reported, even for unsampled and zero
+     * sized allocations.
+     */
+    auto overlap = m_allocations.end();
+    auto next = m_allocations.lower_bound(ptr);
+    if (next != m_allocations.end() &&
+        (next->first == ptr ||
+         (sampled && static_cast<char *>(next->first) < end))) {
+        overlap = next;
+    } else if (sampled && next != m_allocations.begin()) {
+        auto prev = std::prev(next);
+        if (static_cast<char *>(prev->first) + prev->second.m_size >
+            static_cast<char *>(ptr)) {
+            overlap = prev;
+        }
+    }
 
-        if (ptr < i_end && i_beg < end) {
-            std::stringstream msg;
+    if (overlap != m_allocations.end()) {
+        std::stringstream msg;
 
-            msg << "Allocation error: allocation at " << ptr << " (size "
-                << size << ") overlaps with previous allocation " << i_beg
-                << " (size " << i_size << ").";
+        msg << "Allocation error: allocation at " << ptr << " (size "
+            << size << ") overlaps with previous allocation "
+            << overlap->first << " (size " << overlap->second.m_size << ").";
 
-            throw std::logic_error(msg.str());
-        }
+        throw std::logic_error(msg.str());
     }
 
     /*
      * Store the current allocation as an outstanding one.
      */
-    m_allocations.emplace(ptr, std::pair(size, align));
+    m_allocations.emplace_hint(next, ptr, allocation{size, align, sampled});
 
     return ptr;
 }
 
 void debug_memory_resource::do_deallocate(void *ptr, std::size_t size,
                                           std::size_t align) {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
     auto alloc_it = m_allocations.find(ptr);
 
     /*
-     * Check whether we are aware of this allocation at all.
+     * Check whether we are aware of this allocation at all. Since all
+     * outstanding allocations are recorded, unknown pointers are always
+     * invalid or double frees.
      */
     if (alloc_it == m_allocations.end()) {
         std::stringstream msg;
@@ -75,17 +111,18 @@ void debug_memory_resource::do_deallocate(void *ptr, std::size_t size,
         throw std::logic_error(msg.str());
     }
 
-    const std::pair<std::size_t, std::size_t> &alloc = alloc_it->second;
+    const allocation &alloc = alloc_it->second;
 
     /*
-     * Check whether the deallocation arguments match the allocation arguments.
+     * Check whether the deallocation arguments match the allocation
+     * arguments, for the sampled allocations.
      */
-    if (alloc.first != size || alloc.second != align) {
+    if (alloc.m_sampled && (alloc.m_size != size || alloc.m_align != align)) {
         std::stringstream msg;
 
         msg << "Deallocation error: allocation at " << ptr
-            << " exists, but size (" << size << " vs. " << alloc.first
-            << ") or alignment (" << align << " vs. " << alloc.second
+            << " exists, but size (" << size << " vs. " << alloc.m_size
+            << ") or alignment (" << align << " vs. " << alloc.m_align
             << ") does not match.";
 
         throw std::logic_error(msg.str());
@@ -93,14 +130,15 @@ void debug_memory_resource::do_deallocate(void *ptr, std::size_t size,
 
     /*
      * After we confirm that this pointer was actually allocated with this
-     * resource, we can continue by forwarding the request upstream.
+     * resource, we remove it from our administration. Before the memory
+     * could be handed out again by the upstream resource.
      */
-    m_upstream.deallocate(ptr, size, align);
+    m_allocations.erase(alloc_it);
+    lock.unlock();
 
     /*
-     * Finally, we need to make sure that the allocation is removed from our
-     * administration.
+     * Finally, we can forward the request upstream.
      */
-    m_allocations.erase(alloc_it);
+    m_upstream.deallocate(ptr, size, align);
 }
 }  // namespace vecmem
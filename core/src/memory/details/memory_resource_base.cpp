@@ -8,6 +8,9 @@
 // Local include(s).
 #include "vecmem/memory/details/memory_resource_base.hpp"
 
+// System include(s).
+#include <new>
+
 namespace vecmem::details {
 
 bool memory_resource_base::do_is_equal(
@@ -18,4 +21,50 @@ bool memory_resource_base::do_is_equal(
     return (this == &other);
 }
 
+memory_resource_base::ownership memory_resource_base::owns(
+    const void *p) const noexcept {
+
+    return do_owns(p);
+}
+
+memory_resource_base::ownership memory_resource_base::do_owns(
+    const void *) const noexcept {
+
+    // By default a memory resource can not tell what memory it allocated.
+    return ownership::unknown;
+}
+
+void *memory_resource_base::try_allocate(std::size_t bytes,
+                                         std::size_t alignment) {
+
+    return do_try_allocate(bytes, alignment);
+}
+
+void *memory_resource_base::do_try_allocate(std::size_t bytes,
+                                            std::size_t alignment) {
+
+    // By default fall back to the exception based interface.
+    try {
+        return allocate(bytes, alignment);
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void *try_allocate(memory_resource &resource, std::size_t bytes,
+                   std::size_t alignment) {
+
+    // Use the nothrow interface if the memory resource provides it.
+    memory_resource_base *base =
+        dynamic_cast<memory_resource_base *>(&resource);
+    if (base != nullptr) {
+        return base->try_allocate(bytes, alignment);
+    }
+    try {
+        return resource.allocate(bytes, alignment);
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
 }  // namespace vecmem::details
@@ -0,0 +1,198 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/memory/file_mapped_memory_resource.hpp"
+
+#include "bump_allocate.hpp"
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // not _WIN32
+
+namespace vecmem {
+
+#ifdef _WIN32
+
+file_mapped_memory_resource::file_mapped_memory_resource(const std::string&,
+                                                         std::size_t,
+                                                         access_hint)
+    : m_fd(-1), m_begin(nullptr), m_size(0), m_next(nullptr) {
+
+    throw std::runtime_error(
+        "vecmem::file_mapped_memory_resource is not available on Windows");
+}
+
+file_mapped_memory_resource::~file_mapped_memory_resource() {}
+
+void file_mapped_memory_resource::sync(bool) {}
+
+void file_mapped_memory_resource::prefetch(const void*, std::size_t) const {}
+
+#else
+
+namespace {
+
+/// Throw an exception describing the last failed system call
+[[noreturn]] void throw_error(const std::string& what,
+                              const std::string& path) {
+
+    throw std::runtime_error("Failed to " + what + " file \"" + path +
+                             "\": " + std::strerror(errno));
+}
+
+}  // namespace
+
+file_mapped_memory_resource::file_mapped_memory_resource(
+    const std::string& path, std::size_t size, access_hint hint)
+    : m_fd(-1), m_begin(nullptr), m_size(0), m_next(nullptr) {
+
+    /*
+     * Open the file, and make sure that it is large enough.
+     */
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        throw_error("open", path);
+    }
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) {
+        close(m_fd);
+        throw_error("stat", path);
+    }
+    const std::size_t file_size = static_cast<std::size_t>(st.st_size);
+    if (size == 0) {
+        size = file_size;
+    } else if ((file_size < size) &&
+               (ftruncate(m_fd, static_cast<off_t>(size)) != 0)) {
+        close(m_fd);
+        throw_error("resize", path);
+    }
+    if (size == 0) {
+        close(m_fd);
+        throw std::runtime_error("Can not map empty file \"" + path + "\"");
+    }
+
+    /*
+     * Map the file. Modifications of the memory are written back into it.
+     */
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (p == MAP_FAILED) {
+        close(m_fd);
+        throw_error("map", path);
+    }
+    m_begin = static_cast<char*>(p);
+    m_size = size;
+    m_next.store(m_begin);
+
+    /*
+     * Advise the kernel about the expected access pattern. This is just an
+     * optimisation, so failures are ignored.
+     */
+    if (hint != access_hint::normal) {
+        const int advice =
+            (hint == access_hint::sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        if (madvise(m_begin, m_size, advice) != 0) {
+            VECMEM_DEBUG_MSG(2, "Failed to advise the access pattern of %p",
+                             p);
+        }
+    }
+    VECMEM_DEBUG_MSG(2, "Mapped %lu bytes of file \"%s\" at %p", m_size,
+                     path.c_str(), p);
+}
+
+file_mapped_memory_resource::~file_mapped_memory_resource() {
+
+    munmap(m_begin, m_size);
+    close(m_fd);
+}
+
+void file_mapped_memory_resource::sync(bool wait) {
+
+    if (msync(m_begin, m_size, (wait ? MS_SYNC : MS_ASYNC)) != 0) {
+        VECMEM_DEBUG_MSG(1, "Failed to synchronise the mapping at %p",
+                         static_cast<void*>(m_begin));
+    }
+}
+
+void file_mapped_memory_resource::prefetch(const void* p,
+                                           std::size_t size) const {
+
+    /*
+     * The advised region has to start on a page boundary.
+     */
+    static const std::uintptr_t page_size =
+        static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p);
+    const std::uintptr_t begin = address - address % page_size;
+    if (madvise(reinterpret_cast<void*>(begin), size + (address - begin),
+                MADV_WILLNEED) != 0) {
+        VECMEM_DEBUG_MSG(2, "Failed to prefetch %lu bytes at %p", size, p);
+    }
+}
+
+#endif  // _WIN32
+
+std::size_t file_mapped_memory_resource::size() const {
+
+    return m_size;
+}
+
+std::size_t file_mapped_memory_resource::offset_of(const void* p) const {
+
+    return static_cast<std::size_t>(static_cast<const char*>(p) - m_begin);
+}
+
+void file_mapped_memory_resource::reset() {
+
+    m_next.store(m_begin, std::memory_order_release);
+}
+
+void* file_mapped_memory_resource::do_allocate(std::size_t size,
+                                               std::size_t alignment) {
+
+    void* res = do_try_allocate(size, alignment);
+    if (res == nullptr) {
+        throw std::bad_alloc();
+    }
+    return res;
+}
+
+void* file_mapped_memory_resource::do_try_allocate(std::size_t size,
+                                                   std::size_t alignment) {
+
+    return details::bump_allocate(m_next, m_begin + m_size, size, alignment);
+}
+
+file_mapped_memory_resource::ownership file_mapped_memory_resource::do_owns(
+    const void* p) const noexcept {
+
+    const char* ptr = static_cast<const char*>(p);
+    return (((ptr >= m_begin) && (ptr < m_begin + m_size))
+                ? ownership::owned
+                : ownership::not_owned);
+}
+
+void file_mapped_memory_resource::do_deallocate(void*, std::size_t,
+                                                std::size_t) {
+    /*
+     * Memory is only reclaimed all at once, with reset().
+     */
+    return;
+}
+
+}  // namespace vecmem
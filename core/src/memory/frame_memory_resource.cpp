@@ -0,0 +1,91 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/memory/frame_memory_resource.hpp"
+
+#include "vecmem/memory/contiguous_memory_resource.hpp"
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <algorithm>
+
+namespace vecmem {
+
+frame_memory_resource::frame_memory_resource(memory_resource& upstream,
+                                             std::size_t frame_size,
+                                             std::size_t n_frames,
+                                             std::size_t growth_factor)
+    : m_frame(0) {
+
+    /*
+     * Create the arenas of all frames. At least two of them, as otherwise
+     * the memory of a frame could not outlive the beginning of the next one.
+     */
+    n_frames = std::max(n_frames, static_cast<std::size_t>(2UL));
+    m_arenas.reserve(n_frames);
+    for (std::size_t i = 0; i < n_frames; ++i) {
+        m_arenas.push_back(std::make_unique<contiguous_memory_resource>(
+            upstream, frame_size, growth_factor));
+    }
+}
+
+frame_memory_resource::~frame_memory_resource() {}
+
+void frame_memory_resource::begin_frame() {
+
+    /*
+     * Retire the oldest frame, by reclaiming all memory of its arena, and
+     * start allocating from that arena. The arena is rewound instead of
+     * being reset, so that it would keep all of its chunks. Which avoids
+     * any upstream traffic once the arenas have grown large enough for the
+     * typical frames.
+     */
+    const std::size_t frame = m_frame.load(std::memory_order_relaxed) + 1;
+    m_arenas[frame % m_arenas.size()]->rewind({0, 0});
+    m_frame.store(frame, std::memory_order_release);
+    VECMEM_DEBUG_MSG(4, "Began frame %lu", frame);
+}
+
+std::size_t frame_memory_resource::current_frame() const {
+
+    return m_frame.load(std::memory_order_acquire);
+}
+
+std::size_t frame_memory_resource::n_frames() const {
+
+    return m_arenas.size();
+}
+
+void* frame_memory_resource::do_allocate(std::size_t size,
+                                         std::size_t alignment) {
+
+    return m_arenas[current_frame() % m_arenas.size()]->allocate(size,
+                                                                 alignment);
+}
+
+frame_memory_resource::ownership frame_memory_resource::do_owns(
+    const void* p) const noexcept {
+
+    for (const std::unique_ptr<contiguous_memory_resource>& arena : m_arenas) {
+        if (arena->owns(p) == ownership::owned) {
+            return ownership::owned;
+        }
+    }
+    return ownership::not_owned;
+}
+
+void frame_memory_resource::do_deallocate(void*, std::size_t, std::size_t) {
+    /*
+     * Memory is reclaimed one whole frame at a time, so individual
+     * de-allocations are no-ops.
+     */
+    return;
+}
+
+}  // namespace vecmem
@@ -12,13 +12,97 @@
 #include "vecmem/utils/debug.hpp"
 
 // System include(s).
+#include <algorithm>
 #include <cstdlib>
+#include <limits>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#endif  // _WIN32
+#ifdef __linux__
+#include <sys/mman.h>
+#endif  // __linux__
 
 namespace vecmem {
 
-void *host_memory_resource::do_allocate(std::size_t bytes, std::size_t) {
+host_memory_resource::host_memory_resource(std::size_t huge_page_threshold)
+    : m_huge_page_threshold(huge_page_threshold) {}
+
+std::size_t host_memory_resource::huge_page_threshold() const {
+
+    return m_huge_page_threshold;
+}
+
+void *host_memory_resource::do_allocate(std::size_t bytes,
+                                        std::size_t alignment) {
+
+    void *ptr = do_try_allocate(bytes, alignment);
+    if ((ptr == nullptr) && (bytes != 0)) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *host_memory_resource::do_try_allocate(std::size_t bytes,
+                                            std::size_t alignment) {
+
+    /*
+     * Large allocations, if requested, are aligned to and padded to the
+     * huge page size, so that the kernel could back all of them with huge
+     * pages.
+     */
+    const bool huge =
+        ((m_huge_page_threshold != 0) && (bytes >= m_huge_page_threshold));
+    if (huge) {
+        /*
+         * Requests that can not be padded without overflowing can not be
+         * satisfied anyway.
+         */
+        if (bytes > std::numeric_limits<std::size_t>::max() -
+                        (huge_page_size - 1)) {
+            return nullptr;
+        }
+        alignment = std::max(alignment, huge_page_size);
+        bytes = ((bytes + huge_page_size - 1) / huge_page_size) *
+                huge_page_size;
+    }
+
+    void *ptr = nullptr;
+#ifdef _WIN32
+    /*
+     * On Windows memory from _aligned_malloc must be freed with
+     * _aligned_free, so all allocations have to go through it.
+     */
+    ptr = _aligned_malloc(bytes, alignment);
+#else
+    /*
+     * Plain malloc is good enough for all the alignments that it guarantees.
+     * Memory from posix_memalign can be released with free just the same.
+     */
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(bytes);
+    } else if (posix_memalign(&ptr, std::max(alignment, sizeof(void *)),
+                              bytes) != 0) {
+        ptr = nullptr;
+    }
+#endif  // _WIN32
+
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    /*
+     * Failing to get huge pages is not an error, the memory is still usable
+     * with regular pages.
+     */
+    if (huge && (madvise(ptr, bytes, MADV_HUGEPAGE) != 0)) {
+        VECMEM_DEBUG_MSG(2, "Failed to advise huge pages for %p", ptr);
+    }
+#endif  // __linux__ && MADV_HUGEPAGE
 
-    void *ptr = std::malloc(bytes);
     VECMEM_DEBUG_MSG(4, "Allocated %lu bytes at %p", bytes, ptr);
     return ptr;
 }
@@ -26,7 +110,11 @@ void *host_memory_resource::do_allocate(std::size_t bytes, std::size_t) {
 void host_memory_resource::do_deallocate(void *p, std::size_t, std::size_t) {
 
     VECMEM_DEBUG_MSG(4, "De-allocating memory at %p", p);
+#ifdef _WIN32
+    _aligned_free(p);
+#else
     std::free(p);
+#endif  // _WIN32
 }
 
 bool host_memory_resource::do_is_equal(
@@ -35,7 +123,8 @@ bool host_memory_resource::do_is_equal(
      * All malloc resources are equal to each other, because they have no
      * internal state. Of course they have a shared underlying state in the
      * form of the underlying C library memory manager, but that is not
-     * relevant for us.
+     * relevant for us. Memory allocated with huge pages is also released
+     * the same way as any other memory.
      */
     const host_memory_resource *c;
     c = dynamic_cast<const host_memory_resource *>(&other);
@@ -8,19 +8,171 @@
 
 #include "vecmem/memory/instrumenting_memory_resource.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <mutex>
+
+#include "../utils/atomic_histogram.hpp"
+#include "../utils/thread_shard.hpp"
+#include "../utils/tick_clock.hpp"
+
+namespace vecmem::details {
+
+/// Per-thread shard of the aggregate statistics of
+/// @c vecmem::instrumenting_memory_resource
+struct alignas(cache_line_size) instrumenting_shard {
+
+    /// Type of the counters
+    using counter = std::atomic<std::size_t>;
+
+    /// The number of requests, for sampling the timing measurements
+    counter m_n_requests;
+
+    /// @name Shards of the members of
+    /// @c vecmem::instrumenting_memory_resource::statistics
+    /// @{
+    counter m_n_allocations;
+    counter m_n_failed_allocations;
+    counter m_n_deallocations;
+    counter m_allocated_bytes;
+    counter m_deallocated_bytes;
+    counter m_n_timed_allocations;
+    counter m_allocation_time;
+    counter m_n_timed_deallocations;
+    counter m_deallocation_time;
+    /// @}
+
+    /// @name Shards of the histograms of
+    /// @c vecmem::instrumenting_memory_resource::statistics
+    /// @{
+    atomic_histogram m_size_histogram;
+    atomic_histogram m_allocation_time_histogram;
+    atomic_histogram m_deallocation_time_histogram;
+    /// @}
+
+};  // struct instrumenting_shard
+
+}  // namespace vecmem::details
+
+namespace {
+
+/// Increment a counter of the current thread's shard
+///
+/// The shards are (mostly) used by a single thread each, so this is cheap.
+///
+void add(vecmem::details::instrumenting_shard::counter &c,
+         std::size_t value = 1) {
+
+    c.fetch_add(value, std::memory_order_relaxed);
+}
+
+/// Sum up a counter of all shards
+std::size_t sum(const vecmem::details::instrumenting_shard *shards,
+                vecmem::details::instrumenting_shard::counter
+                    vecmem::details::instrumenting_shard::*member) {
+
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < vecmem::details::n_thread_shards(); ++i) {
+        result += (shards[i].*member).load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+/// Merge the histograms of all shards
+void merge(vecmem::histogram &result,
+           vecmem::details::instrumenting_shard *shards,
+           vecmem::details::atomic_histogram
+               vecmem::details::instrumenting_shard::*member) {
+
+    for (std::size_t i = 0; i < vecmem::details::n_thread_shards(); ++i) {
+        (shards[i].*member).merge_into(result);
+    }
+}
+
+}  // namespace
 
 namespace vecmem {
 instrumenting_memory_resource::instrumenting_memory_resource(
     memory_resource &upstream)
-    : m_upstream(upstream) {}
+    : instrumenting_memory_resource(upstream, recording::full) {}
+
+instrumenting_memory_resource::instrumenting_memory_resource(
+    memory_resource &upstream, recording mode, std::size_t capacity,
+    timing clock, std::size_t timing_sample_rate)
+    : m_upstream(upstream),
+      m_mode(mode),
+      m_timing(clock),
+      m_timing_sample_rate(std::max(timing_sample_rate, std::size_t{1})),
+      m_capacity(capacity),
+      m_shards(std::make_unique<details::instrumenting_shard[]>(
+          details::n_thread_shards())) {
+
+    /*
+     * The ring buffer is allocated up front, and it never grows.
+     */
+    if (m_mode == recording::ring_buffer) {
+        m_events.reserve(m_capacity);
+    }
+    /*
+     * Calibrate the tick counter right away, not during the first request.
+     */
+    if (m_timing == timing::ticks) {
+        static_cast<void>(details::nanoseconds_per_tick());
+    }
+}
+
+instrumenting_memory_resource::~instrumenting_memory_resource() {}
+
+std::vector<instrumenting_memory_resource::memory_event>
+instrumenting_memory_resource::get_events(void) const {
 
-const std::vector<instrumenting_memory_resource::memory_event>
-    &instrumenting_memory_resource::get_events(void) const {
+    std::lock_guard<std::mutex> lock(m_events_mutex);
+
+    /*
+     * Put the events of a full ring buffer into chronological order.
+     */
+    if ((m_mode == recording::ring_buffer) &&
+        (m_events.size() == m_capacity)) {
+        std::vector<memory_event> result;
+        result.reserve(m_capacity);
+        result.insert(result.end(), m_events.begin() + m_next_event,
+                      m_events.end());
+        result.insert(result.end(), m_events.begin(),
+                      m_events.begin() + m_next_event);
+        return result;
+    }
     return m_events;
 }
 
+instrumenting_memory_resource::statistics
+instrumenting_memory_resource::get_statistics(void) const {
+
+    /*
+     * Sum up the statistics of all threads.
+     */
+    using shard = details::instrumenting_shard;
+    const shard *shards = m_shards.get();
+    statistics result;
+    result.m_n_allocations = sum(shards, &shard::m_n_allocations);
+    result.m_n_failed_allocations = sum(shards, &shard::m_n_failed_allocations);
+    result.m_n_deallocations = sum(shards, &shard::m_n_deallocations);
+    result.m_allocated_bytes = sum(shards, &shard::m_allocated_bytes);
+    result.m_deallocated_bytes = sum(shards, &shard::m_deallocated_bytes);
+    result.m_n_timed_allocations = sum(shards, &shard::m_n_timed_allocations);
+    result.m_allocation_time = sum(shards, &shard::m_allocation_time);
+    result.m_n_timed_deallocations =
+        sum(shards, &shard::m_n_timed_deallocations);
+    result.m_deallocation_time = sum(shards, &shard::m_deallocation_time);
+    merge(result.m_size_histogram, m_shards.get(), &shard::m_size_histogram);
+    merge(result.m_allocation_time_histogram, m_shards.get(),
+          &shard::m_allocation_time_histogram);
+    merge(result.m_deallocation_time_histogram, m_shards.get(),
+          &shard::m_deallocation_time_histogram);
+    return result;
+}
+
 void instrumenting_memory_resource::add_pre_allocate_hook(
     std::function<void(std::size_t, std::size_t)> f) {
     m_pre_allocate_hooks.push_back(f);
@@ -36,6 +188,11 @@ void instrumenting_memory_resource::add_pre_deallocate_hook(
     m_pre_deallocate_hooks.push_back(f);
 }
 
+void instrumenting_memory_resource::add_post_deallocate_hook(
+    std::function<void(void *, std::size_t, std::size_t)> f) {
+    m_post_deallocate_hooks.push_back(f);
+}
+
 void *instrumenting_memory_resource::do_allocate(std::size_t size,
                                                  std::size_t align) {
     /*
@@ -48,10 +205,13 @@ void *instrumenting_memory_resource::do_allocate(std::size_t size,
 
     /*
      * We record the time before the request, so we can compute the total
-     * execution time afterwards.
+     * execution time afterwards. Recorded events also remember when the
+     * request was made.
      */
-    std::chrono::high_resolution_clock::time_point t1 =
-        std::chrono::high_resolution_clock::now();
+    const bool timed = time_request();
+    const std::uint64_t start =
+        (m_mode != recording::aggregate ? details::steady_nanoseconds() : 0);
+    const std::uint64_t t1 = (timed ? now() : 0);
 
     void *ptr;
 
@@ -65,33 +225,22 @@ void *instrumenting_memory_resource::do_allocate(std::size_t size,
         ptr = m_upstream.allocate(size, align);
     } catch (std::bad_alloc &) {
         ptr = nullptr;
+    } catch (...) {
+        /*
+         * Any other exception is passed on to the user as it is. But the
+         * request has to be finished first, as the post-allocation hooks
+         * must run for every request that the pre-allocation hooks saw.
+         */
+        finish_allocation(size, align, nullptr, (timed ? elapsed(t1) : 0),
+                          timed, start);
+        throw;
     }
 
     /*
-     * Record the time after the allocation, and compute the difference in
-     * nanoseconds from the start of the allocation.
-     */
-    std::chrono::high_resolution_clock::time_point t2 =
-        std::chrono::high_resolution_clock::now();
-
-    std::size_t time =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
-
-    /*
-     * Add a new allocation event with the size, alignment, pointer, and time
-     * of what has just happened.
-     */
-    m_events.emplace_back(memory_event::type::ALLOCATION, size, align, ptr,
-                          time);
-
-    /*
-     * Now, we can run the post-allocation hooks. For failed allocations, the
-     * pointer will be null.
+     * Record the allocation, and run the post-allocation hooks.
      */
-    for (const std::function<void(std::size_t, std::size_t, void *)> &f :
-         m_post_allocate_hooks) {
-        f(size, align, ptr);
-    }
+    finish_allocation(size, align, ptr, (timed ? elapsed(t1) : 0), timed,
+                      start);
 
     /*
      * Now we check whether our allocation failed. If that is the case, we just
@@ -118,27 +267,177 @@ void instrumenting_memory_resource::do_deallocate(void *ptr, std::size_t size,
      * As with allocation, we calculate the time taken to process this
      * deallocation.
      */
-    std::chrono::high_resolution_clock::time_point t1 =
-        std::chrono::high_resolution_clock::now();
+    const bool timed = time_request();
+    const std::uint64_t start =
+        (m_mode != recording::aggregate ? details::steady_nanoseconds() : 0);
+    const std::uint64_t t1 = (timed ? now() : 0);
 
     /*
      * The deallocation, like allocation, is a forwarding method.
      */
-    m_upstream.deallocate(ptr, size, align);
+    try {
+        m_upstream.deallocate(ptr, size, align);
+    } catch (...) {
+        /*
+         * Like for allocations, the post-deallocation hooks must run even if
+         * the upstream resource rejected the request.
+         */
+        finish_deallocation(ptr, size, align, (timed ? elapsed(t1) : 0),
+                            timed, start);
+        throw;
+    }
 
     /*
-     * Compute the total elapsed time during the deallocation request.
+     * Register the deallocation, and run the post-deallocation hooks.
      */
-    std::chrono::high_resolution_clock::time_point t2 =
-        std::chrono::high_resolution_clock::now();
+    finish_deallocation(ptr, size, align, (timed ? elapsed(t1) : 0), timed,
+                        start);
+}
 
-    std::size_t time =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+void instrumenting_memory_resource::finish_allocation(
+    std::size_t size, std::size_t align, void *ptr, std::size_t time,
+    bool timed, std::uint64_t start) {
+    /*
+     * Record a new allocation event with the size, alignment, pointer, and
+     * time of what has just happened.
+     */
+    record(memory_event::type::ALLOCATION, size, align, ptr, time, timed,
+           start);
 
+    /*
+     * Now, we can run the post-allocation hooks. For failed allocations, the
+     * pointer will be null.
+     */
+    for (const std::function<void(std::size_t, std::size_t, void *)> &f :
+         m_post_allocate_hooks) {
+        f(size, align, ptr);
+    }
+}
+
+void instrumenting_memory_resource::finish_deallocation(
+    void *ptr, std::size_t size, std::size_t align, std::size_t time,
+    bool timed, std::uint64_t start) {
     /*
      * Register a deallocation event.
      */
-    m_events.emplace_back(memory_event::type::DEALLOCATION, size, align, ptr,
-                          time);
+    record(memory_event::type::DEALLOCATION, size, align, ptr, time, timed,
+           start);
+
+    /*
+     * Finally, run the post-deallocation hooks.
+     */
+    for (const std::function<void(void *, std::size_t, std::size_t)> &f :
+         m_post_deallocate_hooks) {
+        f(ptr, size, align);
+    }
+}
+
+bool instrumenting_memory_resource::time_request() {
+
+    if (m_timing == timing::none) {
+        return false;
+    }
+    if (m_timing_sample_rate == 1) {
+        return true;
+    }
+    details::instrumenting_shard &shard =
+        m_shards[details::thread_shard_index()];
+    return ((shard.m_n_requests.fetch_add(1, std::memory_order_relaxed) %
+             m_timing_sample_rate) == 0);
+}
+
+std::uint64_t instrumenting_memory_resource::now() const {
+
+    if (m_timing == timing::ticks) {
+        return details::read_ticks();
+    }
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch())
+            .count());
+}
+
+std::size_t instrumenting_memory_resource::elapsed(
+    std::uint64_t start) const {
+
+    const std::uint64_t diff = now() - start;
+    if (m_timing == timing::ticks) {
+        return static_cast<std::size_t>(static_cast<double>(diff) *
+                                        details::nanoseconds_per_tick());
+    }
+    return static_cast<std::size_t>(diff);
+}
+
+void instrumenting_memory_resource::record(memory_event::type t,
+                                           std::size_t size,
+                                           std::size_t align, void *ptr,
+                                           std::size_t time, bool timed,
+                                           std::uint64_t start) {
+    /*
+     * Update the aggregate statistics of the current thread.
+     */
+    details::instrumenting_shard &shard =
+        m_shards[details::thread_shard_index()];
+    if (t == memory_event::type::ALLOCATION) {
+        if (ptr == nullptr) {
+            add(shard.m_n_failed_allocations);
+        } else {
+            add(shard.m_n_allocations);
+            add(shard.m_allocated_bytes, size);
+        }
+        if (timed) {
+            add(shard.m_n_timed_allocations);
+            add(shard.m_allocation_time, time);
+        }
+    } else {
+        add(shard.m_n_deallocations);
+        add(shard.m_deallocated_bytes, size);
+        if (timed) {
+            add(shard.m_n_timed_deallocations);
+            add(shard.m_deallocation_time, time);
+        }
+    }
+
+    /*
+     * Fill the (lock-free) histograms of the current thread.
+     */
+    if ((t == memory_event::type::ALLOCATION) && (ptr != nullptr)) {
+        shard.m_size_histogram.record(size);
+    }
+    if (timed) {
+        ((t == memory_event::type::ALLOCATION)
+             ? shard.m_allocation_time_histogram
+             : shard.m_deallocation_time_histogram)
+            .record(time);
+    }
+
+    /*
+     * Store the event itself, if requested.
+     */
+    if (m_mode == recording::aggregate) {
+        return;
+    }
+    const std::size_t thread = details::thread_number();
+    std::lock_guard<std::mutex> lock(m_events_mutex);
+    switch (m_mode) {
+        case recording::full:
+            m_events.emplace_back(t, size, align, ptr, time, start, thread);
+            break;
+        case recording::ring_buffer:
+            if (m_capacity == 0) {
+                break;
+            }
+            if (m_events.size() < m_capacity) {
+                m_events.emplace_back(t, size, align, ptr, time, start,
+                                      thread);
+            } else {
+                m_events[m_next_event] =
+                    memory_event(t, size, align, ptr, time, start, thread);
+            }
+            m_next_event = (m_next_event + 1) % m_capacity;
+            break;
+        case recording::aggregate:
+            break;
+    }
 }
 }  // namespace vecmem
@@ -0,0 +1,266 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/memory/mmap_memory_resource.hpp"
+
+#include "prefault.hpp"
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif  // NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+namespace vecmem {
+
+mmap_memory_resource::mmap_memory_resource(bool populate, huge_pages pages,
+                                           bool unmap_on_free)
+    : m_populate(populate),
+      m_huge_pages(pages),
+      m_unmap_on_free(unmap_on_free) {
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    m_page_size = static_cast<std::size_t>(info.dwPageSize);
+#else
+    m_page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif  // _WIN32
+}
+
+mmap_memory_resource::~mmap_memory_resource() {
+
+    release_unused();
+}
+
+std::size_t mmap_memory_resource::page_size() const {
+
+    return m_page_size;
+}
+
+std::size_t mmap_memory_resource::release_unused() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& mapping : m_retained) {
+        unmap(mapping.second, mapping.first);
+    }
+    m_retained.clear();
+    const std::size_t result = m_retained_bytes;
+    m_retained_bytes = 0;
+    return result;
+}
+
+std::size_t mmap_memory_resource::retained_bytes() const {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_retained_bytes;
+}
+
+void* mmap_memory_resource::do_allocate(std::size_t size,
+                                        std::size_t alignment) {
+
+    const std::size_t bytes = mapping_size(size);
+
+    /*
+     * Try to re-use a suitably aligned mapping of the same size first, if
+     * mappings are being kept around.
+     */
+    if (!m_unmap_on_free) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto range = m_retained.equal_range(bytes);
+        for (auto it = range.first; it != range.second; ++it) {
+            void* p = it->second;
+            if (reinterpret_cast<std::uintptr_t>(p) % alignment == 0) {
+                m_retained.erase(it);
+                m_retained_bytes -= bytes;
+                VECMEM_DEBUG_MSG(4, "Re-used mapping of %lu bytes at %p",
+                                 bytes, p);
+                return p;
+            }
+        }
+    }
+
+    void* p = map(bytes, alignment);
+    VECMEM_DEBUG_MSG(4, "Mapped %lu bytes at %p", bytes, p);
+    return p;
+}
+
+void mmap_memory_resource::do_deallocate(void* p, std::size_t size,
+                                         std::size_t) {
+
+    const std::size_t bytes = mapping_size(size);
+
+    if (m_unmap_on_free) {
+        VECMEM_DEBUG_MSG(4, "Un-mapping %lu bytes at %p", bytes, p);
+        unmap(p, bytes);
+    } else {
+        VECMEM_DEBUG_MSG(4, "Keeping mapping of %lu bytes at %p", bytes, p);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retained.emplace(bytes, p);
+        m_retained_bytes += bytes;
+    }
+}
+
+std::size_t mmap_memory_resource::mapping_size(std::size_t size) const {
+
+    /*
+     * Mappings are made in multiples of the page size. Of the huge page size
+     * if huge pages are used, so that all of the mapping could be backed by
+     * them.
+     */
+    const std::size_t granularity =
+        (m_huge_pages == huge_pages::none ? m_page_size : huge_page_size);
+    size = std::max(size, static_cast<std::size_t>(1UL));
+    return ((size + granularity - 1) / granularity) * granularity;
+}
+
+#ifdef _WIN32
+
+void* mmap_memory_resource::map(std::size_t size, std::size_t alignment) {
+
+    /*
+     * VirtualAlloc returns memory aligned to the allocation granularity of
+     * the system (64 kiB), larger alignments can not be guaranteed.
+     */
+    void* p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT,
+                           PAGE_READWRITE);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    if (reinterpret_cast<std::uintptr_t>(p) % alignment != 0) {
+        VirtualFree(p, 0, MEM_RELEASE);
+        throw std::bad_alloc();
+    }
+    if (m_populate) {
+        details::prefault(p, size, m_page_size);
+    }
+    return p;
+}
+
+void mmap_memory_resource::unmap(void* p, std::size_t) {
+
+    VirtualFree(p, 0, MEM_RELEASE);
+}
+
+#else
+
+void* mmap_memory_resource::map(std::size_t size, std::size_t alignment) {
+
+#ifdef MAP_ANONYMOUS
+    static constexpr int base_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#else
+    static constexpr int base_flags = MAP_PRIVATE | MAP_ANON;
+#endif  // MAP_ANONYMOUS
+
+#ifdef MAP_HUGETLB
+    /*
+     * Try to get the memory from the huge page pool. Such mappings are
+     * always aligned to the huge page size. If the pool is exhausted (or
+     * was never set up), fall back to transparent huge pages.
+     */
+    if ((m_huge_pages == huge_pages::hugetlb) &&
+        (alignment <= huge_page_size)) {
+        int flags = base_flags | MAP_HUGETLB;
+#ifdef MAP_POPULATE
+        if (m_populate) {
+            flags |= MAP_POPULATE;
+        }
+#endif  // MAP_POPULATE
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p != MAP_FAILED) {
+            return p;
+        }
+        VECMEM_DEBUG_MSG(2,
+                         "Could not map %lu bytes from the huge page pool, "
+                         "using transparent huge pages instead",
+                         size);
+    }
+#endif  // MAP_HUGETLB
+
+    /*
+     * Mappings are only guaranteed to be page aligned. So for larger
+     * alignments (including that of huge pages), map a larger region, and
+     * un-map the parts of it before and after the aligned region.
+     */
+    if (m_huge_pages != huge_pages::none) {
+        alignment = std::max(alignment, huge_page_size);
+    }
+    const std::size_t padding =
+        (alignment > m_page_size ? alignment - m_page_size : 0);
+
+    /*
+     * If no trimming can be needed, and the memory does not need to be
+     * advised before being faulted in, let the kernel pre-fault it.
+     */
+    int flags = base_flags;
+    bool populated = false;
+#ifdef MAP_POPULATE
+    if (m_populate && (padding == 0) && (m_huge_pages == huge_pages::none)) {
+        flags |= MAP_POPULATE;
+        populated = true;
+    }
+#endif  // MAP_POPULATE
+
+    void* raw =
+        mmap(nullptr, size + padding, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    char* begin = static_cast<char*>(raw);
+    char* p = begin;
+    if (padding != 0) {
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw);
+        p = begin + (alignment - address % alignment) % alignment;
+        if (p != begin) {
+            munmap(begin, static_cast<std::size_t>(p - begin));
+        }
+        char* end = begin + size + padding;
+        if (p + size != end) {
+            munmap(p + size, static_cast<std::size_t>(end - (p + size)));
+        }
+    }
+
+#ifdef MADV_HUGEPAGE
+    /*
+     * Failing to get huge pages is not an error, the memory is still usable
+     * with regular pages.
+     */
+    if ((m_huge_pages != huge_pages::none) &&
+        (madvise(p, size, MADV_HUGEPAGE) != 0)) {
+        VECMEM_DEBUG_MSG(2, "Failed to advise huge pages for %p",
+                         static_cast<void*>(p));
+    }
+#endif  // MADV_HUGEPAGE
+
+    if (m_populate && !populated) {
+        details::prefault(p, size, m_page_size);
+    }
+    return p;
+}
+
+void mmap_memory_resource::unmap(void* p, std::size_t size) {
+
+    if (munmap(p, size) != 0) {
+        VECMEM_DEBUG_MSG(1, "Failed to un-map %lu bytes at %p", size, p);
+    }
+}
+
+#endif  // _WIN32
+
+}  // namespace vecmem
@@ -0,0 +1,242 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "multi_arena.hpp"
+
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <iterator>
+
+namespace vecmem::details {
+
+remote_free_queue::remote_free_queue() {
+
+    for (std::size_t i = 0; i < capacity; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool remote_free_queue::push(block const& b) noexcept {
+
+    /*
+     * Claim the next free cell. A cell is free for position pos if its
+     * sequence number is pos, and it still holds an unread block if its
+     * sequence number is behind that.
+     */
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    cell* c = nullptr;
+    while (true) {
+        c = &cells_[pos % capacity];
+        std::size_t const sequence =
+            c->sequence.load(std::memory_order_acquire);
+        if (sequence == pos) {
+            if (tail_.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (sequence < pos) {
+            return false;
+        } else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * Publish the block to the consumer.
+     */
+    c->value = b;
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool remote_free_queue::pop(block& b) noexcept {
+
+    cell& c = cells_[head_ % capacity];
+    if (c.sequence.load(std::memory_order_acquire) != head_ + 1) {
+        return false;
+    }
+
+    /*
+     * Take the block, and make the cell available to the producers again.
+     */
+    b = c.value;
+    c.sequence.store(head_ + capacity, std::memory_order_release);
+    ++head_;
+    return true;
+}
+
+multi_arena::multi_arena(std::size_t initial_size, std::size_t maximum_size,
+                         memory_resource& mm, std::size_t n_arenas)
+    : global_(initial_size, maximum_size, mm) {
+
+    // create the requested number of sub-arenas, but at least one
+    n_arenas = std::max(n_arenas, static_cast<std::size_t>(1u));
+    sub_arenas_.reserve(n_arenas);
+    for (std::size_t i = 0; i < n_arenas; ++i) {
+        sub_arenas_.push_back(std::make_unique<sub_arena>(*this, i));
+    }
+}
+
+void* multi_arena::allocate(std::size_t bytes) {
+
+    // large blocks come from the global arena directly
+    if (bytes >= large_block_size) {
+        std::lock_guard<std::shared_mutex> lock(global_mutex_);
+        return global_.allocate(bytes);
+    }
+
+    // small blocks come from the sub-arena of the current thread
+    sub_arena& s = *(sub_arenas_[current_sub_arena()]);
+    std::lock_guard<std::mutex> lock(s.mutex_);
+    drain_remote_frees(s);
+    return s.arena_.allocate(bytes);
+}
+
+bool multi_arena::deallocate(void* p, std::size_t bytes) {
+
+    std::size_t const owner = find_owner(p);
+
+    // blocks of the global arena
+    if (owner == sub_arenas_.size()) {
+        std::lock_guard<std::shared_mutex> lock(global_mutex_);
+        return global_.deallocate(p, bytes);
+    }
+
+    // hand blocks of other threads' sub-arenas over to their owners without
+    // waiting for their locks, as long as their queues are not full
+    sub_arena& s = *(sub_arenas_[owner]);
+    if (owner != current_sub_arena() && s.remote_frees_.push({p, bytes})) {
+        return true;
+    }
+
+    // with the lock of the sub-arena taken anyway, also return the blocks
+    // waiting in its queue, so that they would not get stuck there if the
+    // owning thread stopped allocating
+    std::lock_guard<std::mutex> lock(s.mutex_);
+    drain_remote_frees(s);
+    return s.arena_.deallocate(p, bytes);
+}
+
+bool multi_arena::owns(void const* p) const {
+
+    // the superblocks of the sub-arenas are all allocated from the global
+    // arena, so it's enough to ask that. the superblocks of the global arena
+    // only change rarely, so concurrent queries only need a shared lock.
+    std::shared_lock<std::shared_mutex> lock(global_mutex_);
+    return global_.owns(p);
+}
+
+std::size_t multi_arena::release_unused(std::size_t max_retained_bytes) {
+
+    // give all free superblocks of the sub-arenas back to the global arena
+    for (std::unique_ptr<sub_arena>& s : sub_arenas_) {
+        std::lock_guard<std::mutex> lock(s->mutex_);
+        drain_remote_frees(*s);
+        s->arena_.release_unused(0);
+    }
+
+    std::lock_guard<std::shared_mutex> lock(global_mutex_);
+    return global_.release_unused(max_retained_bytes);
+}
+
+void multi_arena::set_release_watermarks(std::size_t high_watermark,
+                                         std::size_t low_watermark) {
+
+    for (std::unique_ptr<sub_arena>& s : sub_arenas_) {
+        std::lock_guard<std::mutex> lock(s->mutex_);
+        s->arena_.set_release_watermarks(sub_arena_superblock_size,
+                                         sub_arena_superblock_size);
+    }
+
+    std::lock_guard<std::shared_mutex> lock(global_mutex_);
+    global_.set_release_watermarks(high_watermark, low_watermark);
+}
+
+std::size_t multi_arena::current_sub_arena() const {
+
+    // threads are given consecutive identifiers the first time that they use
+    // any multi-arena, which distributes the threads of a thread pool evenly
+    // over the sub-arenas
+    static std::atomic<std::size_t> next_thread_id{0};
+    thread_local std::size_t const thread_id =
+        next_thread_id.fetch_add(1, std::memory_order_relaxed);
+
+    return thread_id % sub_arenas_.size();
+}
+
+std::size_t multi_arena::find_owner(void* p) const {
+
+    std::shared_lock<std::shared_mutex> lock(owners_mutex_);
+
+    // find the last superblock of a sub-arena starting at, or before `p`
+    auto const it = owners_.upper_bound(static_cast<char*>(p));
+    if (it == owners_.begin() ||
+        static_cast<char*>(p) >= std::prev(it)->second.first) {
+        return sub_arenas_.size();
+    }
+    return std::prev(it)->second.second;
+}
+
+void multi_arena::drain_remote_frees(sub_arena& s) {
+
+    block b;
+    while (s.remote_frees_.pop(b)) {
+        s.arena_.deallocate(b.pointer(), b.size());
+    }
+}
+
+multi_arena::sub_arena_upstream::sub_arena_upstream(multi_arena& owner,
+                                                    std::size_t index)
+    : owner_(owner), index_(index) {}
+
+void* multi_arena::sub_arena_upstream::do_allocate(std::size_t bytes,
+                                                   std::size_t) {
+
+    void* p = nullptr;
+    {
+        std::lock_guard<std::shared_mutex> lock(owner_.global_mutex_);
+        p = owner_.global_.allocate(bytes);
+    }
+    VECMEM_DEBUG_MSG(3, "Allocated superblock of %lu bytes at %p for arena %lu",
+                     bytes, p, index_);
+
+    // record which sub-arena owns this new superblock
+    std::unique_lock<std::shared_mutex> lock(owner_.owners_mutex_);
+    owner_.owners_.emplace(
+        static_cast<char*>(p),
+        std::make_pair(static_cast<char*>(p) + bytes, index_));
+    return p;
+}
+
+void multi_arena::sub_arena_upstream::do_deallocate(void* p, std::size_t bytes,
+                                                    std::size_t) {
+
+    {
+        std::unique_lock<std::shared_mutex> lock(owner_.owners_mutex_);
+        owner_.owners_.erase(static_cast<char*>(p));
+    }
+
+    std::lock_guard<std::shared_mutex> lock(owner_.global_mutex_);
+    owner_.global_.deallocate(p, bytes);
+}
+
+bool multi_arena::sub_arena_upstream::do_is_equal(
+    memory_resource const& other) const noexcept {
+
+    return (this == &other);
+}
+
+multi_arena::sub_arena::sub_arena(multi_arena& owner, std::size_t index)
+    : upstream_(owner, index),
+      arena_(sub_arena_superblock_size, arena::default_maximum_size,
+             upstream_) {}
+
+}  // namespace vecmem::details
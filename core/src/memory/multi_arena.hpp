@@ -0,0 +1,183 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "arena.hpp"
+#include "vecmem/memory/memory_resource.hpp"
+
+// System include(s).
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace vecmem::details {
+
+// bounded, lock-free queue of blocks freed by threads other than the owner of
+// a sub-arena. any number of threads may push blocks into it, but only one
+// thread at a time (the one holding the lock of the sub-arena) may pop them.
+class remote_free_queue {
+public:
+    // the number of blocks that the queue can hold
+    static constexpr std::size_t capacity = 256;
+
+    remote_free_queue();
+
+    // add a block to the queue
+    //
+    // @param[in] b the freed block
+    // @return true if the block was added, false if the queue was full
+    bool push(block const& b) noexcept;
+
+    // remove the oldest block from the queue
+    //
+    // @param[out] b the removed block
+    // @return true if a block was removed, false if the queue was empty
+    bool pop(block& b) noexcept;
+
+private:
+    struct cell {
+        // the position that the cell can next be written (pos) or read
+        // (pos + 1) at
+        std::atomic<std::size_t> sequence;
+        block value;
+    };
+
+    std::array<cell, capacity> cells_;
+    // the position of the next push, shared by all producers
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    // the position of the next pop, only used by the consumer
+    alignas(64) std::size_t head_{0};
+};  // class remote_free_queue
+
+// arena made of per-thread sub-arenas, on top of a global arena.
+//
+// small blocks are allocated by every thread from the sub-arena assigned to
+// it, and the sub-arenas get their superblocks from the global arena. large
+// blocks are allocated from the global arena directly. blocks freed by a
+// thread that does not own them are handed to their sub-arena through a
+// lock-free queue, which is drained whenever the lock of the sub-arena is
+// taken: on allocations, locked deallocations and `release_unused`.
+class multi_arena {
+public:
+    // blocks of at least this size are allocated from the global arena
+    static constexpr std::size_t large_block_size = minimum_superblock_size;
+    // the size of the superblocks of the sub-arenas
+    static constexpr std::size_t sub_arena_superblock_size =
+        4 * minimum_superblock_size;
+
+    // Construct a `multi_arena`
+    //
+    // @param[in] initial_size the initial size of the global arena
+    // @param[in] maximum_size the maximum size of the global arena
+    // @param[in] mm the upstream resource of the global arena
+    // @param[in] n_arenas the number of sub-arenas
+    multi_arena(std::size_t initial_size, std::size_t maximum_size,
+                memory_resource& mm, std::size_t n_arenas);
+
+    // Allocates memory of size at least `bytes`
+    //
+    // @param[in] bytes the size in bytes of the allocation
+    // @return void* pointer to the newly allocated memory
+    void* allocate(std::size_t bytes);
+
+    // Deallocate memory pointed to by `p`
+    //
+    // @param[in] p the pointer of the memory
+    // @param[in] bytes the size in bytes of the deallocation
+    // @return if the allocation was found, false otherwise
+    bool deallocate(void* p, std::size_t bytes);
+
+    // Check whether `p` points into memory managed by the multi-arena
+    //
+    // @param[in] p the pointer to check
+    // @return true if `p` is inside of a superblock of the global arena
+    bool owns(void const* p) const;
+
+    // Release entirely free superblocks of the sub-arenas to the global
+    // arena, and entirely free superblocks of the global arena to the
+    // upstream resource
+    //
+    // @param[in] max_retained_bytes the maximal size of the entirely free
+    // superblocks to keep in the global arena
+    // @return the number of bytes released to the upstream resource
+    std::size_t release_unused(std::size_t max_retained_bytes);
+
+    // Release entirely free superblocks automatically. the sub-arenas give
+    // back all of their free superblocks beyond one to the global arena.
+    //
+    // @param[in] high_watermark the size of entirely free superblocks in the
+    // global arena above which they are released after a deallocation
+    // @param[in] low_watermark the size of entirely free superblocks to keep
+    // in the global arena after such a release
+    void set_release_watermarks(std::size_t high_watermark,
+                                std::size_t low_watermark);
+
+private:
+    // upstream resource of the sub-arenas, allocating their superblocks from
+    // the global arena, and keeping track of which sub-arena owns which
+    // superblock
+    class sub_arena_upstream : public memory_resource {
+    public:
+        sub_arena_upstream(multi_arena& owner, std::size_t index);
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t) override;
+        bool do_is_equal(memory_resource const& other) const noexcept override;
+
+        multi_arena& owner_;
+        std::size_t index_;
+    };  // class sub_arena_upstream
+
+    // a single sub-arena, aligned to a typical cache line size so that the
+    // locks of different sub-arenas would not share cache lines
+    struct alignas(64) sub_arena {
+        sub_arena(multi_arena& owner, std::size_t index);
+
+        // lock protecting `arena_`
+        std::mutex mutex_;
+        sub_arena_upstream upstream_;
+        arena arena_;
+        // blocks freed by other threads, waiting to be returned to `arena_`
+        remote_free_queue remote_frees_;
+    };  // struct sub_arena
+
+    // the index of the sub-arena that the current thread allocates from
+    std::size_t current_sub_arena() const;
+
+    // the index of the sub-arena owning pointer `p`, or the number of
+    // sub-arenas if `p` was allocated from the global arena
+    std::size_t find_owner(void* p) const;
+
+    // return all blocks freed by other threads to a sub-arena, whose lock
+    // must be held by the caller
+    static void drain_remote_frees(sub_arena& s);
+
+    // lock protecting `global_`, which ownership queries only take shared
+    mutable std::shared_mutex global_mutex_;
+    // the global arena, on top of the upstream resource
+    arena global_;
+    // map from the start addresses of the superblocks of the sub-arenas to
+    // their end addresses and owning sub-arenas
+    std::map<char*, std::pair<char*, std::size_t>> owners_;
+    // lock protecting `owners_`, which is only modified when sub-arenas get
+    // or give back superblocks
+    mutable std::shared_mutex owners_mutex_;
+    // the sub-arenas
+    std::vector<std::unique_ptr<sub_arena>> sub_arenas_;
+};  // class multi_arena
+
+}  // namespace vecmem::details
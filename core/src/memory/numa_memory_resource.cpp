@@ -0,0 +1,201 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/memory/numa_memory_resource.hpp"
+
+#include "prefault.hpp"
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // __linux__
+
+namespace {
+
+/// The number of bits in a word of a node mask
+constexpr std::size_t mask_word_bits = 8 * sizeof(unsigned long);
+
+/// @name Constants from the Linux kernel's @c mempolicy.h
+/// @{
+constexpr int mpol_preferred = 1;
+constexpr int mpol_bind = 2;
+constexpr int mpol_interleave = 3;
+constexpr unsigned long mpol_f_node = 1;
+constexpr unsigned long mpol_f_addr = 2;
+/// @}
+
+/// Read the list of online NUMA nodes of the system
+std::vector<unsigned int> read_online_nodes() {
+
+    /*
+     * The file holds a comma separated list of node ranges, like "0-3,5".
+     * If it is not available, assume a single node.
+     */
+    std::vector<unsigned int> result;
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string range;
+    while (std::getline(file, range, ',')) {
+        try {
+            const std::size_t dash = range.find('-');
+            const unsigned long first = std::stoul(range.substr(0, dash));
+            const unsigned long last =
+                (dash == std::string::npos
+                     ? first
+                     : std::stoul(range.substr(dash + 1)));
+            for (unsigned long node = first; node <= last; ++node) {
+                result.push_back(static_cast<unsigned int>(node));
+            }
+        } catch (const std::exception&) {
+            VECMEM_DEBUG_MSG(1, "Could not parse NUMA node range \"%s\"",
+                             range.c_str());
+        }
+    }
+    if (result.empty()) {
+        result.push_back(0);
+    }
+    return result;
+}
+
+/// Get the (cached) list of online NUMA nodes of the system
+const std::vector<unsigned int>& online_nodes() {
+
+    static const std::vector<unsigned int> nodes = read_online_nodes();
+    return nodes;
+}
+
+/// Create a node mask holding the specified nodes
+std::vector<unsigned long> make_nodemask(
+    const std::vector<unsigned int>& nodes) {
+
+    const unsigned int max_node = *std::max_element(nodes.begin(), nodes.end());
+    std::vector<unsigned long> result(max_node / mask_word_bits + 1, 0UL);
+    for (unsigned int node : nodes) {
+        result[node / mask_word_bits] |= (1UL << (node % mask_word_bits));
+    }
+    return result;
+}
+
+/// Set the memory policy of a memory region, if possible
+void set_policy([[maybe_unused]] void* p, [[maybe_unused]] std::size_t size,
+                [[maybe_unused]] int mode,
+                [[maybe_unused]] const std::vector<unsigned long>& nodemask) {
+
+#if defined(__linux__) && defined(SYS_mbind)
+    /*
+     * Failing to set the policy is not an error, the memory is usable just
+     * the same.
+     */
+    if (syscall(SYS_mbind, p, size, mode, nodemask.data(),
+                nodemask.size() * mask_word_bits + 1, 0U) != 0) {
+        VECMEM_DEBUG_MSG(2, "Failed to set the NUMA policy of %p", p);
+    }
+#endif  // __linux__ && SYS_mbind
+}
+
+}  // namespace
+
+namespace vecmem {
+
+numa_memory_resource::numa_memory_resource(policy pol, unsigned int node,
+                                           bool populate)
+    : m_policy(pol),
+      m_populate(populate),
+      m_mmap(populate && (n_nodes() == 1)) {
+
+    /*
+     * Nothing needs to be done on machines with a single node. Otherwise set
+     * up the node mask of the bind and interleave policies.
+     */
+    if (n_nodes() == 1) {
+        return;
+    }
+    const std::vector<unsigned int>& nodes = online_nodes();
+    if (m_policy == policy::interleave) {
+        m_nodemask = make_nodemask(nodes);
+    } else if (m_policy == policy::bind) {
+        if (std::find(nodes.begin(), nodes.end(), node) != nodes.end()) {
+            m_nodemask = make_nodemask({node});
+        } else {
+            VECMEM_DEBUG_MSG(1, "NUMA node %u is not available", node);
+        }
+    }
+}
+
+numa_memory_resource::policy numa_memory_resource::get_policy() const {
+
+    return m_policy;
+}
+
+unsigned int numa_memory_resource::n_nodes() {
+
+    return static_cast<unsigned int>(online_nodes().size());
+}
+
+unsigned int numa_memory_resource::current_node() {
+
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node;
+    }
+#endif  // __linux__ && SYS_getcpu
+    return 0;
+}
+
+int numa_memory_resource::node_of([[maybe_unused]] const void* p) {
+
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, p,
+                mpol_f_node | mpol_f_addr) == 0) {
+        return node;
+    }
+#endif  // __linux__ && SYS_get_mempolicy
+    return -1;
+}
+
+void* numa_memory_resource::do_allocate(std::size_t size,
+                                        std::size_t alignment) {
+
+    void* p = m_mmap.allocate(size, alignment);
+    if (n_nodes() == 1) {
+        return p;
+    }
+
+    /*
+     * Set the policy of the memory before it would be touched for the first
+     * time, so that its pages would be allocated on the right node(s) right
+     * away.
+     */
+    if (m_policy == policy::local) {
+        set_policy(p, size, mpol_preferred, make_nodemask({current_node()}));
+    } else if (!m_nodemask.empty()) {
+        set_policy(p, size,
+                   (m_policy == policy::bind ? mpol_bind : mpol_interleave),
+                   m_nodemask);
+    }
+    if (m_populate) {
+        details::prefault(p, size, m_mmap.page_size());
+    }
+    return p;
+}
+
+void numa_memory_resource::do_deallocate(void* p, std::size_t size,
+                                         std::size_t alignment) {
+
+    m_mmap.deallocate(p, size, alignment);
+}
+
+}  // namespace vecmem
@@ -0,0 +1,30 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// System include(s).
+#include <cstddef>
+
+namespace vecmem::details {
+
+/// Fault in every page of a memory region, by writing to each of them
+///
+/// @param p The beginning of the memory region
+/// @param size The size of the memory region
+/// @param page_size The size of the pages backing the memory region
+///
+inline void prefault(void* p, std::size_t size, std::size_t page_size) {
+
+    volatile char* ptr = static_cast<volatile char*>(p);
+    for (std::size_t i = 0; i < size; i += page_size) {
+        ptr[i] = 0;
+    }
+}
+
+}  // namespace vecmem::details
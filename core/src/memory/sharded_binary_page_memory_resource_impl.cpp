@@ -0,0 +1,192 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "sharded_binary_page_memory_resource_impl.hpp"
+
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iterator>
+
+namespace vecmem::details {
+
+sharded_binary_page_memory_resource_impl::
+    sharded_binary_page_memory_resource_impl(memory_resource &upstream,
+                                             std::size_t n_shards)
+    : m_upstream(upstream) {
+
+    /*
+     * Create the requested number of shards, but at least one.
+     */
+    n_shards = std::max(n_shards, static_cast<std::size_t>(1UL));
+    m_shards.reserve(n_shards);
+    for (std::size_t i = 0; i < n_shards; ++i) {
+        m_shards.push_back(std::make_unique<shard>(*this, i));
+    }
+}
+
+void *sharded_binary_page_memory_resource_impl::do_allocate(
+    std::size_t size, std::size_t align) {
+
+    /*
+     * Allocate from the shard belonging to the current thread.
+     */
+    shard &s = *(m_shards[current_shard()]);
+    std::lock_guard<std::mutex> lock(s.m_mutex);
+    return s.m_pool.do_allocate(size, align);
+}
+
+void sharded_binary_page_memory_resource_impl::do_deallocate(
+    void *p, std::size_t size, std::size_t align) {
+
+    /*
+     * Return the memory to the shard that owns it, which is not necessarily
+     * the shard of the current thread.
+     */
+    const std::size_t index = find_shard(p);
+
+    /*
+     * For debug builds, throw an assertion error if we do not know this
+     * allocation. Otherwise just ignore it.
+     */
+    assert(index != no_shard);
+    if (index == no_shard) {
+        return;
+    }
+
+    shard &s = *(m_shards[index]);
+    std::lock_guard<std::mutex> lock(s.m_mutex);
+    s.m_pool.do_deallocate(p, size, align);
+}
+
+std::size_t sharded_binary_page_memory_resource_impl::release_unused(
+    std::size_t max_retained_bytes) {
+
+    std::size_t released = 0;
+    for (std::unique_ptr<shard> &s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->m_mutex);
+        released +=
+            s->m_pool.release_unused(max_retained_bytes / m_shards.size());
+    }
+    return released;
+}
+
+void sharded_binary_page_memory_resource_impl::set_release_watermarks(
+    std::size_t high_watermark, std::size_t low_watermark) {
+
+    for (std::unique_ptr<shard> &s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->m_mutex);
+        s->m_pool.set_release_watermarks(high_watermark / m_shards.size(),
+                                         low_watermark / m_shards.size());
+    }
+}
+
+std::size_t sharded_binary_page_memory_resource_impl::current_shard() const {
+
+    /*
+     * Threads are given consecutive identifiers the first time that they use
+     * any sharded memory resource. Which distributes the threads of a thread
+     * pool evenly over the shards.
+     */
+    static std::atomic<std::size_t> next_thread_id{0};
+    thread_local const std::size_t thread_id =
+        next_thread_id.fetch_add(1, std::memory_order_relaxed);
+
+    return thread_id % m_shards.size();
+}
+
+std::size_t sharded_binary_page_memory_resource_impl::find_shard(
+    void *p) const {
+
+    std::shared_lock<std::shared_mutex> lock(m_owners_mutex);
+
+    /*
+     * Find the last superpage that starts at, or before the pointer.
+     */
+    auto it = m_owners.upper_bound(static_cast<std::byte *>(p));
+
+    /*
+     * Let the caller know if the pointer is not in any of the superpages.
+     */
+    if ((it == m_owners.begin()) ||
+        (static_cast<std::byte *>(p) >= std::prev(it)->second.first)) {
+        return no_shard;
+    }
+    return std::prev(it)->second.second;
+}
+
+bool sharded_binary_page_memory_resource_impl::owns(const void *p) const {
+
+    std::shared_lock<std::shared_mutex> lock(m_owners_mutex);
+
+    /*
+     * Find the last superpage that starts at, or before the pointer, and
+     * check whether the pointer is inside of it.
+     */
+    const std::byte *ptr = static_cast<const std::byte *>(p);
+    auto it = m_owners.upper_bound(const_cast<std::byte *>(ptr));
+    return ((it != m_owners.begin()) && (ptr < std::prev(it)->second.first));
+}
+
+sharded_binary_page_memory_resource_impl::shard_upstream::shard_upstream(
+    sharded_binary_page_memory_resource_impl &owner, std::size_t index)
+    : m_owner(owner), m_index(index) {}
+
+void *sharded_binary_page_memory_resource_impl::shard_upstream::do_allocate(
+    std::size_t size, std::size_t align) {
+
+    /*
+     * Perform the allocation with the upstream resource, which itself may not
+     * be thread-safe.
+     */
+    void *p = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_owner.m_upstream_mutex);
+        p = m_owner.m_upstream.allocate(size, align);
+    }
+    VECMEM_DEBUG_MSG(3, "Allocated superpage of %lu bytes at %p for shard %lu",
+                     size, p, m_index);
+
+    /*
+     * Record which shard owns this new superpage.
+     */
+    std::unique_lock<std::shared_mutex> lock(m_owner.m_owners_mutex);
+    m_owner.m_owners.emplace(
+        static_cast<std::byte *>(p),
+        std::make_pair(static_cast<std::byte *>(p) + size, m_index));
+
+    return p;
+}
+
+void sharded_binary_page_memory_resource_impl::shard_upstream::do_deallocate(
+    void *p, std::size_t size, std::size_t align) {
+
+    {
+        std::unique_lock<std::shared_mutex> lock(m_owner.m_owners_mutex);
+        m_owner.m_owners.erase(static_cast<std::byte *>(p));
+    }
+
+    std::lock_guard<std::mutex> lock(m_owner.m_upstream_mutex);
+    m_owner.m_upstream.deallocate(p, size, align);
+}
+
+bool sharded_binary_page_memory_resource_impl::shard_upstream::do_is_equal(
+    const memory_resource &other) const noexcept {
+
+    return (this == &other);
+}
+
+sharded_binary_page_memory_resource_impl::shard::shard(
+    sharded_binary_page_memory_resource_impl &owner, std::size_t index)
+    : m_upstream(owner, index), m_pool(m_upstream) {}
+
+}  // namespace vecmem::details
@@ -0,0 +1,154 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "binary_page_memory_resource_impl.hpp"
+#include "vecmem/memory/memory_resource.hpp"
+
+// System include(s).
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace vecmem::details {
+
+/**
+ * @brief Thread-safe implementation of @c vecmem::binary_page_memory_resource
+ *
+ * Superpages are distributed over a number of independent shards, each one
+ * being a @c vecmem::details::binary_page_memory_resource_impl protected by
+ * its own lock. Every thread allocates from the shard assigned to it, so that
+ * threads working on different shards never contend with each other.
+ * Deallocations are routed to the shard owning the superpage that the pointer
+ * belongs to, which may be a different one than the calling thread's.
+ */
+struct sharded_binary_page_memory_resource_impl {
+
+    /// Constructor, on top of another memory resource
+    sharded_binary_page_memory_resource_impl(memory_resource &upstream,
+                                             std::size_t n_shards);
+
+    /// @name Functions implementing the @c vecmem::memory_resource interface
+    /// @{
+
+    /// Allocate a blob of memory
+    void *do_allocate(std::size_t size, std::size_t align);
+    /// De-allocate a previously allocated memory blob
+    void do_deallocate(void *p, std::size_t size, std::size_t align);
+
+    /// @}
+
+    /**
+     * @brief Release fully vacant superpages to the upstream resource.
+     *
+     * The retained memory allowance is split evenly between the shards.
+     *
+     * @return The number of bytes released to the upstream resource.
+     */
+    std::size_t release_unused(std::size_t max_retained_bytes);
+
+    /**
+     * @brief Set up the automatic release of vacant superpages.
+     *
+     * The watermarks are split evenly between the shards.
+     */
+    void set_release_watermarks(std::size_t high_watermark,
+                                std::size_t low_watermark);
+
+    /**
+     * @brief Upstream resource used by the individual shards.
+     *
+     * It serialises the access to the real upstream resource, and keeps track
+     * of which shard owns which superpage.
+     */
+    struct shard_upstream : public memory_resource {
+        /// Constructor with the owning object and the index of the shard
+        shard_upstream(sharded_binary_page_memory_resource_impl &,
+                       std::size_t);
+
+        /// Allocate a superpage for the shard
+        virtual void *do_allocate(std::size_t, std::size_t) override;
+        /// De-allocate a superpage of the shard
+        virtual void do_deallocate(void *, std::size_t, std::size_t) override;
+        /// Compares @c *this for equality with @c other
+        virtual bool do_is_equal(
+            const memory_resource &other) const noexcept override;
+
+        /// The object owning the shard
+        sharded_binary_page_memory_resource_impl &m_owner;
+        /// Index of the shard using this resource
+        std::size_t m_index;
+    };
+
+    /**
+     * @brief A single shard of the memory resource.
+     *
+     * Aligned to a typical cache line size, so that the locks of different
+     * shards would not share cache lines.
+     */
+    struct alignas(64) shard {
+        /// Constructor with the owning object and the index of the shard
+        shard(sharded_binary_page_memory_resource_impl &, std::size_t);
+
+        /// Lock protecting the pool of the shard
+        std::mutex m_mutex;
+        /// Upstream resource of the shard's pool
+        shard_upstream m_upstream;
+        /// The pool of superpages belonging to the shard
+        binary_page_memory_resource_impl m_pool;
+    };
+
+    /**
+     * @brief Return the index of the shard that the current thread should
+     * allocate from.
+     */
+    std::size_t current_shard() const;
+
+    /// Shard index returned for pointers not owned by any of the shards
+    static constexpr std::size_t no_shard = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Return the index of the shard owning a given pointer, or
+     * @c no_shard if no shard owns it.
+     */
+    std::size_t find_shard(void *p) const;
+
+    /**
+     * @brief Check whether a pointer is in one of the superpages of the
+     * shards.
+     */
+    bool owns(const void *p) const;
+
+    /// The upstream memory resource
+    memory_resource &m_upstream;
+    /// Lock serialising the access to the upstream memory resource
+    std::mutex m_upstream_mutex;
+
+    /**
+     * @brief Map from the start addresses of all superpages to their end
+     * addresses and owning shards.
+     *
+     * It is only modified when superpages are allocated or de-allocated, so
+     * it is protected by a reader-writer lock.
+     */
+    std::map<std::byte *, std::pair<std::byte *, std::size_t>> m_owners;
+    /// Lock protecting @c m_owners
+    mutable std::shared_mutex m_owners_mutex;
+
+    /// The shards of the memory resource
+    std::vector<std::unique_ptr<shard>> m_shards;
+
+};  // struct sharded_binary_page_memory_resource_impl
+
+}  // namespace vecmem::details
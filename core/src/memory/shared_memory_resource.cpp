@@ -0,0 +1,285 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/memory/shared_memory_resource.hpp"
+
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // not _WIN32
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif  // __linux__
+
+namespace {
+
+/// Type of the bump pointer, stored at the beginning of the segment
+using offset_type = std::atomic<std::size_t>;
+static_assert(offset_type::is_always_lock_free,
+              "The bump pointer must be usable between processes");
+
+/// The size of the header at the beginning of the segment
+constexpr std::size_t header_size = 64;
+
+}  // namespace
+
+namespace vecmem {
+
+#ifdef _WIN32
+
+shared_memory_resource::shared_memory_resource(std::size_t)
+    : m_fd(-1), m_begin(nullptr), m_size(0) {
+
+    throw std::runtime_error(
+        "vecmem::shared_memory_resource is not available on Windows");
+}
+
+shared_memory_resource::shared_memory_resource(const std::string& name,
+                                               std::size_t size)
+    : shared_memory_resource(size) {
+
+    (void)name;
+}
+
+shared_memory_resource::shared_memory_resource(from_fd_t, int)
+    : shared_memory_resource(0) {}
+
+shared_memory_resource::~shared_memory_resource() {}
+
+void shared_memory_resource::map(bool) {}
+
+#else
+
+namespace {
+
+/// Throw an exception describing the last failed system call
+[[noreturn]] void throw_error(const std::string& what) {
+
+    throw std::runtime_error("Failed to " + what + ": " +
+                             std::strerror(errno));
+}
+
+/// Create an anonymous shared memory segment
+int create_anonymous_segment() {
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+    /*
+     * Prefer memfd_create, which does not need a name at all.
+     */
+    const int memfd = static_cast<int>(
+        syscall(SYS_memfd_create, "vecmem_shared_memory_resource", 0U));
+    if (memfd >= 0) {
+        return memfd;
+    }
+#endif  // __linux__ && SYS_memfd_create
+
+    /*
+     * Otherwise create a named segment, and remove its name right away.
+     */
+    static std::atomic<unsigned int> counter(0);
+    const std::string name = "/vecmem_" + std::to_string(getpid()) + "_" +
+                             std::to_string(counter++);
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name.c_str());
+    }
+    return fd;
+}
+
+}  // namespace
+
+shared_memory_resource::shared_memory_resource(std::size_t size)
+    : m_fd(create_anonymous_segment()), m_begin(nullptr), m_size(size) {
+
+    if (m_fd < 0) {
+        throw_error("create anonymous shared memory segment");
+    }
+    if (ftruncate(m_fd, static_cast<off_t>(m_size)) != 0) {
+        close(m_fd);
+        throw_error("resize anonymous shared memory segment");
+    }
+    map(true);
+}
+
+shared_memory_resource::shared_memory_resource(const std::string& name,
+                                               std::size_t size)
+    : m_fd(-1), m_begin(nullptr), m_size(size) {
+
+    /*
+     * Either create a new segment, or open an existing one.
+     */
+    if (size != 0) {
+        m_fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (m_fd < 0) {
+            throw_error("create shared memory segment \"" + name + "\"");
+        }
+        m_name = name;
+        if (ftruncate(m_fd, static_cast<off_t>(m_size)) != 0) {
+            close(m_fd);
+            shm_unlink(name.c_str());
+            throw_error("resize shared memory segment \"" + name + "\"");
+        }
+    } else {
+        m_fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (m_fd < 0) {
+            throw_error("open shared memory segment \"" + name + "\"");
+        }
+        struct stat st;
+        if (fstat(m_fd, &st) != 0) {
+            close(m_fd);
+            throw_error("stat shared memory segment \"" + name + "\"");
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+    }
+    map(size != 0);
+}
+
+shared_memory_resource::shared_memory_resource(from_fd_t, int fd)
+    : m_fd(fcntl(fd, F_DUPFD_CLOEXEC, 0)), m_begin(nullptr), m_size(0) {
+
+    if (m_fd < 0) {
+        throw_error("duplicate shared memory segment descriptor");
+    }
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) {
+        close(m_fd);
+        throw_error("stat shared memory segment descriptor");
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    map(false);
+}
+
+shared_memory_resource::~shared_memory_resource() {
+
+    munmap(m_begin, m_size);
+    close(m_fd);
+    if (!m_name.empty()) {
+        shm_unlink(m_name.c_str());
+    }
+}
+
+void shared_memory_resource::map(bool initialize) {
+
+    if (m_size <= header_size) {
+        close(m_fd);
+        if (!m_name.empty()) {
+            shm_unlink(m_name.c_str());
+        }
+        throw std::runtime_error("Shared memory segment is too small");
+    }
+    void* p =
+        mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (p == MAP_FAILED) {
+        close(m_fd);
+        if (!m_name.empty()) {
+            shm_unlink(m_name.c_str());
+        }
+        throw_error("map shared memory segment");
+    }
+    m_begin = static_cast<char*>(p);
+    if (initialize) {
+        new (m_begin) offset_type(header_size);
+    }
+    VECMEM_DEBUG_MSG(2, "Mapped shared memory segment of %lu bytes at %p",
+                     m_size, p);
+}
+
+#endif  // _WIN32
+
+int shared_memory_resource::fd() const {
+
+    return m_fd;
+}
+
+std::size_t shared_memory_resource::size() const {
+
+    return m_size;
+}
+
+std::size_t shared_memory_resource::offset_of(const void* p) const {
+
+    const char* ptr = static_cast<const char*>(p);
+    assert((ptr >= m_begin) && (ptr < m_begin + m_size));
+    return static_cast<std::size_t>(ptr - m_begin);
+}
+
+void* shared_memory_resource::at_offset(std::size_t offset) const {
+
+    assert(offset < m_size);
+    return m_begin + offset;
+}
+
+void shared_memory_resource::reset() {
+
+    reinterpret_cast<offset_type*>(m_begin)->store(header_size,
+                                                   std::memory_order_release);
+}
+
+void* shared_memory_resource::do_allocate(std::size_t size,
+                                          std::size_t alignment) {
+
+    void* res = do_try_allocate(size, alignment);
+    if (res == nullptr) {
+        throw std::bad_alloc();
+    }
+    return res;
+}
+
+void* shared_memory_resource::do_try_allocate(std::size_t size,
+                                              std::size_t alignment) {
+
+    /*
+     * The segment is mapped at a page boundary in every process, so
+     * alignments are the same everywhere, and it's enough to work with
+     * offsets.
+     */
+    offset_type& next_offset = *(reinterpret_cast<offset_type*>(m_begin));
+    std::size_t next = next_offset.load(std::memory_order_relaxed);
+    while (true) {
+        const std::size_t res = (next + alignment - 1) & ~(alignment - 1);
+        if ((res > m_size) || (m_size - res < size)) {
+            return nullptr;
+        }
+        if (next_offset.compare_exchange_weak(next, res + size,
+                                              std::memory_order_relaxed)) {
+            VECMEM_DEBUG_MSG(4, "Allocated %lu bytes at offset %lu", size,
+                             res);
+            return m_begin + res;
+        }
+    }
+}
+
+shared_memory_resource::ownership shared_memory_resource::do_owns(
+    const void* p) const noexcept {
+
+    const char* ptr = static_cast<const char*>(p);
+    return (((ptr >= m_begin) && (ptr < m_begin + m_size))
+                ? ownership::owned
+                : ownership::not_owned);
+}
+
+void shared_memory_resource::do_deallocate(void*, std::size_t, std::size_t) {
+    /*
+     * Memory is only reclaimed all at once, with reset().
+     */
+    return;
+}
+
+}  // namespace vecmem
@@ -30,6 +30,13 @@ void terminal_memory_resource::do_deallocate(void *, std::size_t, std::size_t) {
     return;
 }
 
+void *terminal_memory_resource::do_try_allocate(std::size_t, std::size_t) {
+    /*
+     * Allocation always fails, without having to throw an exception.
+     */
+    return nullptr;
+}
+
 bool terminal_memory_resource::do_is_equal(
     const memory_resource &other) const noexcept {
     /*
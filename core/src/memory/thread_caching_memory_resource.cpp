@@ -0,0 +1,58 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/memory/thread_caching_memory_resource.hpp"
+
+#include "thread_caching_memory_resource_impl.hpp"
+
+namespace vecmem {
+
+thread_caching_memory_resource::thread_caching_memory_resource(
+    memory_resource& upstream, std::size_t max_cached_blocks,
+    std::size_t max_block_size)
+    : m_impl(std::make_unique<details::thread_caching_memory_resource_impl>(
+          upstream, max_cached_blocks, max_block_size)) {}
+
+thread_caching_memory_resource::~thread_caching_memory_resource() {}
+
+void thread_caching_memory_resource::flush() {
+
+    m_impl->flush();
+}
+
+std::size_t thread_caching_memory_resource::cache_hits() const {
+
+    return m_impl->cache_hits();
+}
+
+std::size_t thread_caching_memory_resource::cache_misses() const {
+
+    return m_impl->cache_misses();
+}
+
+double thread_caching_memory_resource::hit_rate() const {
+
+    const std::size_t hits = cache_hits();
+    const std::size_t total = hits + cache_misses();
+    return (total == 0 ? 0. : static_cast<double>(hits) / total);
+}
+
+void* thread_caching_memory_resource::do_allocate(std::size_t size,
+                                                  std::size_t align) {
+
+    return m_impl->do_allocate(size, align);
+}
+
+void thread_caching_memory_resource::do_deallocate(void* p, std::size_t size,
+                                                   std::size_t align) {
+
+    m_impl->do_deallocate(p, size, align);
+}
+
+}  // namespace vecmem
@@ -0,0 +1,278 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "thread_caching_memory_resource_impl.hpp"
+
+#include "vecmem/utils/debug.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+
+/// The size of the smallest size class
+constexpr std::size_t min_block_size = alignof(std::max_align_t);
+/// The alignment of all cached blocks
+constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+/// Increment a counter that is only ever written by a single thread
+inline void increment(std::atomic<std::size_t> &counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+}
+
+/// The caches of the current thread, for all memory resources it has used
+struct thread_cache_list {
+    std::vector<std::unique_ptr<vecmem::details::thread_cache>> m_caches;
+};
+
+thread_local thread_cache_list thread_caches;
+thread_local vecmem::details::thread_cache *last_thread_cache = nullptr;
+
+}  // namespace
+
+namespace vecmem::details {
+
+thread_caching_shared_state::thread_caching_shared_state(
+    memory_resource &upstream)
+    : m_upstream(&upstream) {}
+
+thread_cache::thread_cache(std::shared_ptr<thread_caching_shared_state> state,
+                           std::uint64_t resource_id, std::size_t n_classes,
+                           std::size_t max_cached_blocks)
+    : m_state(std::move(state)),
+      m_resource_id(resource_id),
+      m_magazines(n_classes) {
+
+    /*
+     * Reserve all memory that the magazines may ever need up front, so that
+     * caching a block would never allocate memory.
+     */
+    for (std::vector<void *> &magazine : m_magazines) {
+        magazine.reserve(max_cached_blocks);
+    }
+}
+
+thread_cache::~thread_cache() {
+
+    /*
+     * Give back all cached blocks, unless the memory resource has already
+     * done that itself while being destroyed.
+     */
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    if (m_state->m_upstream == nullptr) {
+        return;
+    }
+    flush_all();
+    m_state->m_retired_hits += m_hits.load(std::memory_order_relaxed);
+    m_state->m_retired_misses += m_misses.load(std::memory_order_relaxed);
+    m_state->m_caches.erase(std::find(m_state->m_caches.begin(),
+                                      m_state->m_caches.end(), this));
+}
+
+void thread_cache::flush_class(std::size_t size_class, std::size_t keep) {
+
+    std::vector<void *> &magazine = m_magazines[size_class];
+    while (magazine.size() > keep) {
+        m_state->m_upstream->deallocate(
+            magazine.back(), min_block_size << size_class, block_alignment);
+        magazine.pop_back();
+    }
+}
+
+void thread_cache::flush_all() {
+
+    for (std::size_t i = 0; i < m_magazines.size(); ++i) {
+        flush_class(i, 0);
+    }
+}
+
+thread_caching_memory_resource_impl::thread_caching_memory_resource_impl(
+    memory_resource &upstream, std::size_t max_cached_blocks,
+    std::size_t max_block_size)
+    : m_state(std::make_shared<thread_caching_shared_state>(upstream)),
+      m_max_cached_blocks(
+          std::max(max_cached_blocks, static_cast<std::size_t>(1UL))),
+      m_n_classes(1) {
+
+    /*
+     * Give every memory resource a unique identifier, which is never reused
+     * (unlike its address) by later memory resources.
+     */
+    static std::atomic<std::uint64_t> next_id{0};
+    m_id = next_id.fetch_add(1, std::memory_order_relaxed);
+
+    /*
+     * Set up enough size classes to cover the requested block size.
+     */
+    while ((min_block_size << (m_n_classes - 1)) < max_block_size) {
+        ++m_n_classes;
+    }
+}
+
+thread_caching_memory_resource_impl::~thread_caching_memory_resource_impl() {
+
+    /*
+     * Flush the caches of all threads that are still alive, and detach them
+     * from the upstream resource.
+     */
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    for (thread_cache *cache : m_state->m_caches) {
+        cache->flush_all();
+    }
+    m_state->m_caches.clear();
+    m_state->m_upstream = nullptr;
+}
+
+void *thread_caching_memory_resource_impl::do_allocate(std::size_t size,
+                                                       std::size_t align) {
+
+    /*
+     * Pass allocations that can not be cached on to upstream directly.
+     */
+    const std::size_t sc = size_class(size, align);
+    if (sc == m_n_classes) {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        return m_state->m_upstream->allocate(size, align);
+    }
+
+    /*
+     * Serve the allocation from the calling thread's cache if possible.
+     */
+    thread_cache &cache = local_cache();
+    std::vector<void *> &magazine = cache.m_magazines[sc];
+    if (!magazine.empty()) {
+        void *p = magazine.back();
+        magazine.pop_back();
+        increment(cache.m_hits);
+        return p;
+    }
+
+    /*
+     * Otherwise allocate a block of the full size of the size class, so that
+     * it could be cached once it is freed.
+     */
+    increment(cache.m_misses);
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    return m_state->m_upstream->allocate(min_block_size << sc,
+                                         block_alignment);
+}
+
+void thread_caching_memory_resource_impl::do_deallocate(void *p,
+                                                        std::size_t size,
+                                                        std::size_t align) {
+
+    const std::size_t sc = size_class(size, align);
+    if (sc == m_n_classes) {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        m_state->m_upstream->deallocate(p, size, align);
+        return;
+    }
+
+    /*
+     * If the magazine is full, give half of it back to upstream, so that
+     * the next few de-allocations would not need to take the lock again.
+     */
+    thread_cache &cache = local_cache();
+    if (cache.m_magazines[sc].size() >= m_max_cached_blocks) {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        VECMEM_DEBUG_MSG(5, "Flushing size class %lu of the thread cache", sc);
+        cache.flush_class(sc, m_max_cached_blocks / 2);
+    }
+    cache.m_magazines[sc].push_back(p);
+}
+
+void thread_caching_memory_resource_impl::flush() {
+
+    thread_cache &cache = local_cache();
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    cache.flush_all();
+}
+
+std::size_t thread_caching_memory_resource_impl::cache_hits() const {
+
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    std::size_t result = m_state->m_retired_hits;
+    for (const thread_cache *cache : m_state->m_caches) {
+        result += cache->m_hits.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+std::size_t thread_caching_memory_resource_impl::cache_misses() const {
+
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    std::size_t result = m_state->m_retired_misses;
+    for (const thread_cache *cache : m_state->m_caches) {
+        result += cache->m_misses.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+std::size_t thread_caching_memory_resource_impl::size_class(
+    std::size_t size, std::size_t align) const {
+
+    if ((align > block_alignment) ||
+        (size > (min_block_size << (m_n_classes - 1)))) {
+        return m_n_classes;
+    }
+
+    std::size_t result = 0;
+    while ((min_block_size << result) < size) {
+        ++result;
+    }
+    return result;
+}
+
+thread_cache &thread_caching_memory_resource_impl::local_cache() {
+
+    /*
+     * Most of the time a thread uses the same memory resource as in its
+     * previous call.
+     */
+    if ((last_thread_cache != nullptr) &&
+        (last_thread_cache->m_resource_id == m_id)) {
+        return *last_thread_cache;
+    }
+
+    /*
+     * Look for the cache among all caches of the thread.
+     */
+    std::vector<std::unique_ptr<thread_cache>> &caches =
+        thread_caches.m_caches;
+    for (std::unique_ptr<thread_cache> &cache : caches) {
+        if (cache->m_resource_id == m_id) {
+            last_thread_cache = cache.get();
+            return *cache;
+        }
+    }
+
+    /*
+     * Drop the caches of memory resources that have been destroyed in the
+     * meantime, and create a new cache for this memory resource.
+     */
+    caches.erase(std::remove_if(caches.begin(), caches.end(),
+                                [](const std::unique_ptr<thread_cache> &c) {
+                                    std::lock_guard<std::mutex> lock(
+                                        c->m_state->m_mutex);
+                                    return c->m_state->m_upstream == nullptr;
+                                }),
+                 caches.end());
+    caches.push_back(std::make_unique<thread_cache>(
+        m_state, m_id, m_n_classes, m_max_cached_blocks));
+    {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        m_state->m_caches.push_back(caches.back().get());
+    }
+    last_thread_cache = caches.back().get();
+    return *last_thread_cache;
+}
+
+}  // namespace vecmem::details
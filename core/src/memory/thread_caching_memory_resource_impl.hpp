@@ -0,0 +1,152 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/memory_resource.hpp"
+
+// System include(s).
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vecmem::details {
+
+// Forward declaration(s).
+struct thread_cache;
+
+/**
+ * @brief State shared by a thread-caching memory resource and the caches of
+ * all threads using it.
+ *
+ * It is kept alive by the thread caches, so that a thread exiting after the
+ * memory resource was destroyed would still find it.
+ */
+struct thread_caching_shared_state {
+
+    /// Constructor with the upstream memory resource
+    thread_caching_shared_state(memory_resource &upstream);
+
+    /// Lock protecting all members, and the upstream resource
+    std::mutex m_mutex;
+    /// The upstream resource, or @c nullptr once the resource is destroyed
+    memory_resource *m_upstream;
+    /// The caches of the threads currently using the resource
+    std::vector<thread_cache *> m_caches;
+    /// Cache hits of the threads that no longer use the resource
+    std::size_t m_retired_hits = 0;
+    /// Cache misses of the threads that no longer use the resource
+    std::size_t m_retired_misses = 0;
+
+};  // struct thread_caching_shared_state
+
+/**
+ * @brief The cache of a single thread, for a single memory resource.
+ *
+ * It holds a "magazine" of freed blocks for every size class. It is only
+ * ever used by its own thread, except for collecting statistics, and for
+ * flushing it when the memory resource is destroyed.
+ */
+struct thread_cache {
+
+    /// Constructor with the shared state and configuration of the resource
+    thread_cache(std::shared_ptr<thread_caching_shared_state> state,
+                 std::uint64_t resource_id, std::size_t n_classes,
+                 std::size_t max_cached_blocks);
+
+    /// Destructor, called when the owning thread exits
+    ~thread_cache();
+
+    /**
+     * @brief Give cached blocks of one size class back to upstream.
+     *
+     * The lock of the shared state must be held by the caller.
+     *
+     * @param[in] size_class The size class to flush
+     * @param[in] keep The number of blocks to keep in the cache
+     */
+    void flush_class(std::size_t size_class, std::size_t keep);
+
+    /**
+     * @brief Give all cached blocks back to upstream.
+     *
+     * The lock of the shared state must be held by the caller.
+     */
+    void flush_all();
+
+    /// State shared with the memory resource
+    std::shared_ptr<thread_caching_shared_state> m_state;
+    /// Unique identifier of the memory resource that the cache belongs to
+    std::uint64_t m_resource_id;
+    /// Freed blocks, for every size class
+    std::vector<std::vector<void *>> m_magazines;
+    /// Number of allocations served from the cache
+    std::atomic<std::size_t> m_hits{0};
+    /// Number of allocations that could not be served from the cache
+    std::atomic<std::size_t> m_misses{0};
+
+};  // struct thread_cache
+
+/**
+ * @brief The implementation of @c vecmem::thread_caching_memory_resource
+ */
+struct thread_caching_memory_resource_impl {
+
+    /// Constructor, on top of another memory resource
+    thread_caching_memory_resource_impl(memory_resource &upstream,
+                                        std::size_t max_cached_blocks,
+                                        std::size_t max_block_size);
+
+    /// Destructor, flushing the caches of all threads
+    ~thread_caching_memory_resource_impl();
+
+    /// @name Functions implementing the @c vecmem::memory_resource interface
+    /// @{
+
+    /// Allocate a blob of memory
+    void *do_allocate(std::size_t size, std::size_t align);
+    /// De-allocate a previously allocated memory blob
+    void do_deallocate(void *p, std::size_t size, std::size_t align);
+
+    /// @}
+
+    /// Give all blocks cached by the calling thread back to upstream
+    void flush();
+
+    /// Get the number of allocations served from a thread's cache
+    std::size_t cache_hits() const;
+    /// Get the number of cacheable allocations that went to upstream
+    std::size_t cache_misses() const;
+
+    /**
+     * @brief Get the size class of an allocation.
+     *
+     * @return The index of the size class, or the number of size classes if
+     *         the allocation can not be cached.
+     */
+    std::size_t size_class(std::size_t size, std::size_t align) const;
+
+    /// Get (or create) the cache of the calling thread
+    thread_cache &local_cache();
+
+    /// State shared with the thread caches
+    std::shared_ptr<thread_caching_shared_state> m_state;
+    /// Unique identifier of the memory resource
+    std::uint64_t m_id;
+    /// Maximal number of blocks per size class in a thread's cache
+    std::size_t m_max_cached_blocks;
+    /// Number of size classes
+    std::size_t m_n_classes;
+
+};  // struct thread_caching_memory_resource_impl
+
+}  // namespace vecmem::details
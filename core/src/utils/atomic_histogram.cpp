@@ -0,0 +1,53 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "atomic_histogram.hpp"
+
+namespace vecmem::details {
+
+void atomic_histogram::record(std::uint64_t value) {
+
+    // The extremes only need to be updated (rarely) when they change.
+    std::uint64_t current = m_min.load(std::memory_order_relaxed);
+    while ((value < current) &&
+           (!m_min.compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed))) {
+    }
+    current = m_max.load(std::memory_order_relaxed);
+    while ((value > current) &&
+           (!m_max.compare_exchange_weak(current, value,
+                                         std::memory_order_relaxed))) {
+    }
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    // Publish the value in its bucket last, so that a reader seeing it would
+    // also see its effect on the extremes and the sum.
+    m_counts[histogram::bucket_index(value)].fetch_add(
+        1, std::memory_order_release);
+}
+
+void atomic_histogram::merge_into(histogram& result) const {
+
+    histogram snapshot;
+    for (std::size_t i = 0; i < histogram::n_buckets; ++i) {
+        const std::uint64_t count = m_counts[i].load(std::memory_order_acquire);
+        snapshot.m_counts[i] = count;
+        snapshot.m_count += count;
+    }
+    if (snapshot.m_count == 0) {
+        return;
+    }
+    snapshot.m_min = m_min.load(std::memory_order_relaxed);
+    snapshot.m_max = m_max.load(std::memory_order_relaxed);
+    snapshot.m_sum =
+        static_cast<double>(m_sum.load(std::memory_order_relaxed));
+    result.merge(snapshot);
+}
+
+}  // namespace vecmem::details
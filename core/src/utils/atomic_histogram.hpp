@@ -0,0 +1,48 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/utils/histogram.hpp"
+
+// System include(s).
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace vecmem::details {
+
+/// Lock-free version of @c vecmem::histogram, for filling from many threads
+///
+/// Values are recorded with relaxed atomic operations only. Reading the
+/// histogram while it is being filled gives a snapshot that may be missing
+/// some of the values being recorded at that moment.
+///
+class atomic_histogram {
+
+public:
+    /// Record a value
+    void record(std::uint64_t value);
+    /// Add the contents of this histogram to a regular one
+    void merge_into(histogram& result) const;
+
+private:
+    /// The number of values in each bucket
+    std::atomic<std::uint64_t> m_counts[histogram::n_buckets] = {};
+    /// The smallest recorded value
+    std::atomic<std::uint64_t> m_min{
+        std::numeric_limits<std::uint64_t>::max()};
+    /// The largest recorded value
+    std::atomic<std::uint64_t> m_max{0};
+    /// The sum of the recorded values
+    std::atomic<std::uint64_t> m_sum{0};
+
+};  // class atomic_histogram
+
+}  // namespace vecmem::details
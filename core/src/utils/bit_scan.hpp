@@ -0,0 +1,55 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#ifdef VECMEM_HAVE_LZCNT_U64
+#include <intrin.h>
+#endif
+
+namespace vecmem::details {
+
+/// Count the leading zero bits of a (non-zero) value
+inline std::size_t clzl(std::size_t i) {
+#if defined(VECMEM_HAVE_LZCNT_U64)
+    return _lzcnt_u64(i);
+#elif defined(VECMEM_HAVE_BUILTIN_CLZL)
+    return __builtin_clzl(i);
+#else
+    std::size_t b;
+    for (b = 0;
+         !((i << b) & (static_cast<std::size_t>(1UL)
+                       << (std::numeric_limits<std::size_t>::digits - 1UL)));
+         ++b)
+        ;
+    return b;
+#endif
+}
+
+/// Get the position of the highest set bit of a (non-zero) value
+inline std::size_t highest_bit(std::uint64_t value) {
+
+    constexpr std::size_t digits = std::numeric_limits<std::size_t>::digits;
+    if constexpr (digits >= 64) {
+        return digits - 1 - clzl(static_cast<std::size_t>(value));
+    } else {
+        // Scan the two halves of the value separately on 32-bit platforms.
+        const std::size_t high = static_cast<std::size_t>(value >> 32);
+        if (high != 0) {
+            return 32 + digits - 1 - clzl(high);
+        }
+        return digits - 1 - clzl(static_cast<std::size_t>(value));
+    }
+}
+
+}  // namespace vecmem::details
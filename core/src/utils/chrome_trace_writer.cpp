@@ -0,0 +1,240 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/utils/chrome_trace_writer.hpp"
+
+#include "request_stack.hpp"
+#include "thread_shard.hpp"
+#include "tick_clock.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+namespace vecmem::details {
+
+/// A memory resource whose events are written by @c chrome_trace_writer
+struct chrome_trace_source {
+
+    /// The (JSON escaped) name of the resource
+    std::string m_name;
+    /// The amount of memory currently held from the resource
+    std::size_t m_outstanding = 0;
+
+};  // struct chrome_trace_source
+
+}  // namespace vecmem::details
+
+namespace {
+
+/// Stack of the start times of the ongoing requests of the current thread
+using request_starts =
+    vecmem::details::request_stack<vecmem::chrome_trace_writer>;
+
+/// The process identifier used for all events
+constexpr int trace_pid = 1;
+
+/// Escape a string for use in a JSON document
+std::string escape(const std::string& str) {
+
+    std::string result;
+    result.reserve(str.size());
+    for (const char c : str) {
+        if ((c == '"') || (c == '\\')) {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x",
+                          static_cast<unsigned int>(c));
+            result += buffer;
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+/// Open a file for writing a trace into
+std::unique_ptr<std::ostream> open_file(const std::string& path) {
+
+    auto result = std::make_unique<std::ofstream>(path);
+    if (!result->is_open()) {
+        throw std::runtime_error("Failed to open trace file \"" + path +
+                                 "\"");
+    }
+    return result;
+}
+
+}  // namespace
+
+namespace vecmem {
+
+chrome_trace_writer::chrome_trace_writer(std::ostream& out) : m_out(out) {
+
+    m_out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+}
+
+chrome_trace_writer::chrome_trace_writer(const std::string& path)
+    : m_file(open_file(path)), m_out(*m_file) {
+
+    m_out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+}
+
+chrome_trace_writer::~chrome_trace_writer() {
+
+    close();
+}
+
+void chrome_trace_writer::write(const instrumenting_memory_resource& resource,
+                                const std::string& name) {
+
+    // Every call writes the events with a fresh memory counter.
+    details::chrome_trace_source source{escape(name)};
+    for (const instrumenting_memory_resource::memory_event& event :
+         resource.get_events()) {
+        write_memory_event(source, event);
+    }
+}
+
+void chrome_trace_writer::attach(instrumenting_memory_resource& resource,
+                                 const std::string& name) {
+
+    // Set up the description of the resource.
+    details::chrome_trace_source* source = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sources.push_back({escape(name)});
+        source = &(m_sources.back());
+    }
+
+    // Time the requests between the pre- and post-hooks of the resource.
+    using event_type = instrumenting_memory_resource::memory_event;
+    resource.add_pre_allocate_hook([](std::size_t, std::size_t) {
+        request_starts::push(details::steady_nanoseconds());
+    });
+    resource.add_post_allocate_hook(
+        [this, source](std::size_t size, std::size_t align, void* ptr) {
+            const std::uint64_t end = details::steady_nanoseconds();
+            const std::uint64_t start = request_starts::pop(end);
+            write_memory_event(
+                *source, event_type(event_type::type::ALLOCATION, size, align,
+                                    ptr, end - start, start,
+                                    details::thread_number()));
+        });
+    resource.add_pre_deallocate_hook([](void*, std::size_t, std::size_t) {
+        request_starts::push(details::steady_nanoseconds());
+    });
+    resource.add_post_deallocate_hook(
+        [this, source](void* ptr, std::size_t size, std::size_t align) {
+            const std::uint64_t end = details::steady_nanoseconds();
+            const std::uint64_t start = request_starts::pop(end);
+            write_memory_event(
+                *source, event_type(event_type::type::DEALLOCATION, size,
+                                    align, ptr, end - start, start,
+                                    details::thread_number()));
+        });
+}
+
+void chrome_trace_writer::close() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_closed) {
+        return;
+    }
+    m_out << "\n]}\n";
+    m_out.flush();
+    m_closed = true;
+}
+
+void chrome_trace_writer::write_memory_event(
+    details::chrome_trace_source& source,
+    const instrumenting_memory_resource::memory_event& event) {
+
+    using event_type = instrumenting_memory_resource::memory_event::type;
+    const bool allocation = (event.m_type == event_type::ALLOCATION);
+    const bool failed = (allocation && (event.m_ptr == nullptr));
+
+    // Describe the request.
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer),
+                  "\"size\":%zu,\"align\":%zu,\"ptr\":\"%p\"", event.m_size,
+                  event.m_align, event.m_ptr);
+    const std::string args =
+        "\"resource\":\"" + source.m_name + "\"," + buffer;
+    write_complete_event(
+        (allocation ? (failed ? "allocate (failed)" : "allocate")
+                    : "deallocate"),
+        "memory", event.m_start, event.m_time, event.m_thread, args);
+
+    // Update the amount of memory held from the resource. Events of
+    // de-allocations may come without the events of their allocations, if
+    // those were not recorded.
+    if (failed) {
+        return;
+    }
+    std::size_t outstanding = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (allocation) {
+            source.m_outstanding += event.m_size;
+        } else {
+            source.m_outstanding -=
+                std::min(source.m_outstanding, event.m_size);
+        }
+        outstanding = source.m_outstanding;
+    }
+    write_counter_event(source.m_name, event.m_start + event.m_time,
+                        outstanding);
+}
+
+void chrome_trace_writer::write_complete_event(const char* name,
+                                               const char* category,
+                                               std::uint64_t start,
+                                               std::uint64_t duration,
+                                               std::size_t thread,
+                                               const std::string& args) {
+
+    // Chrome traces use microseconds as their unit of time.
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                  "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%i,\"tid\":%zu,"
+                  "\"args\":{",
+                  name, category, static_cast<double>(start) * 1e-3,
+                  static_cast<double>(duration) * 1e-3, trace_pid, thread);
+    write_event(buffer + args + "}}");
+}
+
+void chrome_trace_writer::write_counter_event(const std::string& name,
+                                              std::uint64_t time,
+                                              std::size_t value) {
+
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer),
+                  "\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%i,"
+                  "\"args\":{\"bytes\":%zu}}",
+                  static_cast<double>(time) * 1e-3, trace_pid, value);
+    write_event("{\"name\":\"" + name + buffer);
+}
+
+void chrome_trace_writer::write_event(const std::string& event) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_closed) {
+        return;
+    }
+    m_out << (m_first ? "\n" : ",\n") << event;
+    m_first = false;
+}
+
+}  // namespace vecmem
@@ -0,0 +1,140 @@
+/**
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "vecmem/utils/histogram.hpp"
+
+#include "bit_scan.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace vecmem {
+
+histogram::histogram() : m_counts(n_buckets, 0) {}
+
+void histogram::record(std::uint64_t value, std::uint64_t count) {
+
+    if (count == 0) {
+        return;
+    }
+    m_counts[bucket_index(value)] += count;
+    m_min = ((m_count == 0) ? value : std::min(m_min, value));
+    m_max = ((m_count == 0) ? value : std::max(m_max, value));
+    m_count += count;
+    m_sum += static_cast<double>(value) * static_cast<double>(count);
+}
+
+void histogram::merge(const histogram& other) {
+
+    if (other.m_count == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < n_buckets; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_min = ((m_count == 0) ? other.m_min : std::min(m_min, other.m_min));
+    m_max = ((m_count == 0) ? other.m_max : std::max(m_max, other.m_max));
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+}
+
+void histogram::reset() {
+
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0.;
+}
+
+std::uint64_t histogram::count() const {
+
+    return m_count;
+}
+
+std::uint64_t histogram::min() const {
+
+    return m_min;
+}
+
+std::uint64_t histogram::max() const {
+
+    return m_max;
+}
+
+double histogram::mean() const {
+
+    return ((m_count == 0) ? 0. : m_sum / static_cast<double>(m_count));
+}
+
+std::uint64_t histogram::percentile(double percentile) const {
+
+    if (m_count == 0) {
+        return 0;
+    }
+
+    // Find the bucket holding the value with the requested rank.
+    const double fraction = std::clamp(percentile, 0., 100.) / 100.;
+    const std::uint64_t rank = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(
+            std::ceil(fraction * static_cast<double>(m_count))),
+        1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < n_buckets; ++i) {
+        seen += m_counts[i];
+        if (seen >= rank) {
+            return std::clamp(bucket_upper_bound(i), m_min, m_max);
+        }
+    }
+    return m_max;
+}
+
+std::size_t histogram::bucket_index(std::uint64_t value) {
+
+    // Small values each have a bucket of their own.
+    if (value < sub_buckets) {
+        return static_cast<std::size_t>(value);
+    }
+    // Larger ones are put into one of the linear sub-buckets of their power
+    // of two.
+    const std::size_t shift = details::highest_bit(value) - sub_bucket_bits;
+    return (shift + 1) * sub_buckets +
+           static_cast<std::size_t>((value >> shift) - sub_buckets);
+}
+
+std::uint64_t histogram::bucket_lower_bound(std::size_t index) {
+
+    assert(index < n_buckets);
+    if (index < sub_buckets) {
+        return index;
+    }
+    const std::size_t shift = index / sub_buckets - 1;
+    return static_cast<std::uint64_t>(sub_buckets + index % sub_buckets)
+           << shift;
+}
+
+std::uint64_t histogram::bucket_upper_bound(std::size_t index) {
+
+    assert(index < n_buckets);
+    if (index < sub_buckets) {
+        return index;
+    }
+    const std::size_t shift = index / sub_buckets - 1;
+    return bucket_lower_bound(index) + ((std::uint64_t{1} << shift) - 1);
+}
+
+std::uint64_t histogram::bucket_count(std::size_t index) const {
+
+    assert(index < n_buckets);
+    return m_counts[index];
+}
+
+}  // namespace vecmem
@@ -9,15 +9,114 @@
 // Local include(s).
 #include "vecmem/utils/memory_monitor.hpp"
 
+#include "atomic_histogram.hpp"
+#include "request_stack.hpp"
+#include "thread_shard.hpp"
+#include "tick_clock.hpp"
+
 // System include(s).
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+
+namespace vecmem::details {
+
+/// Per-thread shard of the statistics of @c vecmem::memory_monitor
+struct alignas(cache_line_size) memory_monitor_shard {
+
+    /// The number of allocations
+    std::atomic<std::size_t> m_n_alloc{0};
+    /// Total allocation
+    std::atomic<std::size_t> m_total_alloc{0};
+
+    /// Histogram of the allocation sizes
+    atomic_histogram m_sizes;
+    /// Histogram of the allocation latencies
+    atomic_histogram m_allocation_latencies;
+    /// Histogram of the de-allocation latencies
+    atomic_histogram m_deallocation_latencies;
+    /// Histogram of the allocation lifetimes
+    atomic_histogram m_lifetimes;
+
+};  // struct memory_monitor_shard
+
+/// Slot remembering the allocation time of a sampled allocation
+struct memory_monitor_lifetime_slot {
+
+    /// The sampled allocation, or @c nullptr for a free slot
+    std::atomic<void*> m_ptr{nullptr};
+    /// The tick count at which the allocation was made
+    std::atomic<std::uint64_t> m_time{0};
+
+};  // struct memory_monitor_lifetime_slot
+
+}  // namespace vecmem::details
+
+namespace {
+
+/// Stack of the start times of the ongoing requests of the current thread
+using request_starts = vecmem::details::request_stack<vecmem::memory_monitor>;
+
+/// Get the nanoseconds elapsed between two tick counts
+std::uint64_t elapsed(std::uint64_t start, std::uint64_t end) {
+
+    // Protect against tick counters not being perfectly in sync between
+    // CPU cores.
+    if (end <= start) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(static_cast<double>(end - start) *
+                                      vecmem::details::nanoseconds_per_tick());
+}
+
+/// The number of sampled allocations that lifetimes can be tracked for
+constexpr std::size_t n_lifetime_slots = 4096;
+/// The number of slots that a sampled allocation may be put into
+constexpr std::size_t n_lifetime_probes = 8;
+
+/// Get the first slot that the lifetime of an allocation may be tracked in
+std::size_t lifetime_slot_index(void* ptr) {
+
+    // Mix the bits of the address, as its lowest bits are usually all zero.
+    const std::uint64_t hash =
+        static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(ptr)) *
+        0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(hash >> 32) % n_lifetime_slots;
+}
+
+/// Merge one histogram of all shards
+vecmem::histogram merge(
+    vecmem::details::memory_monitor_shard* shards,
+    vecmem::details::atomic_histogram
+        vecmem::details::memory_monitor_shard::*member) {
+
+    vecmem::histogram result;
+    for (std::size_t i = 0; i < vecmem::details::n_thread_shards(); ++i) {
+        (shards[i].*member).merge_into(result);
+    }
+    return result;
+}
+
+}  // namespace
 
 namespace vecmem {
 
-memory_monitor::memory_monitor(instrumenting_memory_resource& resource) {
+memory_monitor::memory_monitor(instrumenting_memory_resource& resource,
+                               std::size_t lifetime_sample_rate)
+    : m_lifetime_sample_rate(std::max(lifetime_sample_rate, std::size_t{1})),
+      m_shards(std::make_unique<details::memory_monitor_shard[]>(
+          details::n_thread_shards())),
+      m_lifetime_slots(
+          std::make_unique<details::memory_monitor_lifetime_slot[]>(
+              n_lifetime_slots)) {
+
+    // Calibrate the clock right away, not during the first request.
+    static_cast<void>(details::nanoseconds_per_tick());
 
+    resource.add_pre_allocate_hook([this](std::size_t size, std::size_t align) {
+        this->pre_allocate(size, align);
+    });
     resource.add_post_allocate_hook(
         [this](std::size_t size, std::size_t align, void* ptr) {
             this->post_allocate(size, align, ptr);
@@ -26,46 +125,149 @@ memory_monitor::memory_monitor(instrumenting_memory_resource& resource) {
         [this](void* ptr, std::size_t size, std::size_t align) {
             this->pre_deallocate(ptr, size, align);
         });
+    resource.add_post_deallocate_hook(
+        [this](void* ptr, std::size_t size, std::size_t align) {
+            this->post_deallocate(ptr, size, align);
+        });
 }
 
+memory_monitor::~memory_monitor() {}
+
 std::size_t memory_monitor::total_allocation() const {
 
-    return m_total_alloc;
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < details::n_thread_shards(); ++i) {
+        result += m_shards[i].m_total_alloc.load(std::memory_order_relaxed);
+    }
+    return result;
 }
 
 std::size_t memory_monitor::outstanding_allocation() const {
 
-    return m_outstanding_alloc;
+    return m_outstanding_alloc.load(std::memory_order_relaxed);
 }
 
 std::size_t memory_monitor::average_allocation() const {
 
-    return static_cast<std::size_t>(std::round(
-        static_cast<double>(m_total_alloc) / static_cast<double>(m_n_alloc)));
+    std::size_t n_alloc = 0;
+    for (std::size_t i = 0; i < details::n_thread_shards(); ++i) {
+        n_alloc += m_shards[i].m_n_alloc.load(std::memory_order_relaxed);
+    }
+    return static_cast<std::size_t>(
+        std::round(static_cast<double>(total_allocation()) /
+                   static_cast<double>(n_alloc)));
 }
 
 std::size_t memory_monitor::maximal_allocation() const {
 
-    return m_maximum_alloc;
+    return m_maximum_alloc.load(std::memory_order_relaxed);
+}
+
+histogram memory_monitor::size_histogram() const {
+
+    return merge(m_shards.get(), &details::memory_monitor_shard::m_sizes);
+}
+
+histogram memory_monitor::allocation_latency_histogram() const {
+
+    return merge(m_shards.get(),
+                 &details::memory_monitor_shard::m_allocation_latencies);
+}
+
+histogram memory_monitor::deallocation_latency_histogram() const {
+
+    return merge(m_shards.get(),
+                 &details::memory_monitor_shard::m_deallocation_latencies);
+}
+
+histogram memory_monitor::lifetime_histogram() const {
+
+    return merge(m_shards.get(), &details::memory_monitor_shard::m_lifetimes);
+}
+
+void memory_monitor::pre_allocate(std::size_t, std::size_t) {
+
+    request_starts::push(details::read_ticks());
 }
 
 void memory_monitor::post_allocate(std::size_t size, std::size_t, void* ptr) {
 
+    const std::uint64_t now = details::read_ticks();
+    const std::uint64_t start = request_starts::pop(now);
+
     // Don't do anything on failed allocations.
     if (ptr == nullptr) {
         return;
     }
 
-    ++m_n_alloc;
-    m_total_alloc += size;
-    m_outstanding_alloc += size;
-    m_maximum_alloc = std::max(m_outstanding_alloc, m_maximum_alloc);
+    // The peak memory usage needs a global view.
+    const std::size_t outstanding =
+        m_outstanding_alloc.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t maximum = m_maximum_alloc.load(std::memory_order_relaxed);
+    while ((outstanding > maximum) &&
+           (!m_maximum_alloc.compare_exchange_weak(
+               maximum, outstanding, std::memory_order_relaxed))) {
+    }
+
+    // Everything else goes into the shard of this thread.
+    details::memory_monitor_shard& shard =
+        m_shards[details::thread_shard_index()];
+    const std::size_t n_alloc =
+        shard.m_n_alloc.fetch_add(1, std::memory_order_relaxed);
+    shard.m_total_alloc.fetch_add(size, std::memory_order_relaxed);
+    shard.m_sizes.record(size);
+    shard.m_allocation_latencies.record(elapsed(start, now));
+
+    // Remember when (some of) the allocations were made. If all slots that
+    // the allocation could use are taken, it is just not sampled.
+    if ((n_alloc % m_lifetime_sample_rate) != 0) {
+        return;
+    }
+    const std::size_t first = lifetime_slot_index(ptr);
+    for (std::size_t i = 0; i < n_lifetime_probes; ++i) {
+        details::memory_monitor_lifetime_slot& slot =
+            m_lifetime_slots[(first + i) % n_lifetime_slots];
+        void* expected = nullptr;
+        if (slot.m_ptr.compare_exchange_strong(expected, ptr,
+                                               std::memory_order_relaxed)) {
+            slot.m_time.store(now, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void memory_monitor::pre_deallocate(void* ptr, std::size_t size,
+                                    std::size_t) {
+
+    assert(m_outstanding_alloc.load() >= size);
+    m_outstanding_alloc.fetch_sub(size, std::memory_order_relaxed);
+
+    // Record the lifetime of the allocation, if it was sampled. The memory
+    // can only be freed after its allocation returned, so its slot is
+    // fully set up by now.
+    const std::uint64_t now = details::read_ticks();
+    const std::size_t first = lifetime_slot_index(ptr);
+    for (std::size_t i = 0; i < n_lifetime_probes; ++i) {
+        details::memory_monitor_lifetime_slot& slot =
+            m_lifetime_slots[(first + i) % n_lifetime_slots];
+        if (slot.m_ptr.load(std::memory_order_relaxed) == ptr) {
+            const std::uint64_t allocated =
+                slot.m_time.load(std::memory_order_relaxed);
+            slot.m_ptr.store(nullptr, std::memory_order_relaxed);
+            m_shards[details::thread_shard_index()].m_lifetimes.record(
+                elapsed(allocated, now));
+            break;
+        }
+    }
+    request_starts::push(now);
 }
 
-void memory_monitor::pre_deallocate(void*, std::size_t size, std::size_t) {
+void memory_monitor::post_deallocate(void*, std::size_t, std::size_t) {
 
-    assert(m_outstanding_alloc >= size);
-    m_outstanding_alloc -= size;
+    const std::uint64_t now = details::read_ticks();
+    const std::uint64_t start = request_starts::pop(now);
+    m_shards[details::thread_shard_index()].m_deallocation_latencies.record(
+        elapsed(start, now));
 }
 
 }  // namespace vecmem
@@ -0,0 +1,67 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+
+namespace vecmem::details {
+
+/// Per-thread stack of the start times of the ongoing memory requests
+///
+/// Used by the observers of @c vecmem::instrumenting_memory_resource to
+/// measure the duration of requests between their "pre" and "post" hooks.
+/// Being a stack, it supports nested instrumented memory resources. The
+/// @c TAG type gives every type of observer a stack of its own.
+///
+/// The stack is trivially destructible, as memory may be de-allocated from
+/// the destructors of other thread-local objects.
+///
+template <typename TAG>
+class request_stack {
+
+public:
+    /// Remember the start time of a request of the current thread
+    static void push(std::uint64_t start) {
+        if (s_depth < max_depth) {
+            s_starts[s_depth] = start;
+        }
+        ++s_depth;
+    }
+
+    /// Get the start time of the innermost ongoing request of the thread
+    ///
+    /// @param now The current time, returned if the stack is empty
+    ///
+    static std::uint64_t pop(std::uint64_t now) {
+        if (s_depth == 0) {
+            return now;
+        }
+        --s_depth;
+        return ((s_depth < max_depth) ? s_starts[s_depth] : now);
+    }
+
+private:
+    /// The maximal depth of nested requests that are timed
+    static constexpr std::size_t max_depth = 16;
+    /// The start times of the ongoing requests
+    static thread_local std::uint64_t s_starts[max_depth];
+    /// The number of ongoing requests
+    static thread_local std::size_t s_depth;
+
+};  // class request_stack
+
+template <typename TAG>
+thread_local std::uint64_t request_stack<TAG>::s_starts[max_depth] = {};
+
+template <typename TAG>
+thread_local std::size_t request_stack<TAG>::s_depth = 0;
+
+}  // namespace vecmem::details
@@ -0,0 +1,42 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "thread_shard.hpp"
+
+// System include(s).
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace vecmem::details {
+
+std::size_t n_thread_shards() {
+
+    static const std::size_t result = std::clamp(
+        static_cast<std::size_t>(std::thread::hardware_concurrency()),
+        static_cast<std::size_t>(16UL), static_cast<std::size_t>(64UL));
+    return result;
+}
+
+std::size_t thread_number() {
+
+    static std::atomic<std::size_t> next_number{1};
+    thread_local const std::size_t number =
+        next_number.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+std::size_t thread_shard_index() {
+
+    thread_local const std::size_t index =
+        (thread_number() - 1) % n_thread_shards();
+    return index;
+}
+
+}  // namespace vecmem::details
@@ -0,0 +1,43 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// System include(s).
+#include <cstddef>
+
+namespace vecmem::details {
+
+/// Get the number of shards that per-thread statistics are spread over
+///
+/// It is the hardware concurrency of the machine, limited to the range
+/// [16, 64] to bound the memory used by the shards. When more threads than
+/// this use the same object, some of them share a shard. Which is still
+/// correct, as the shards are only updated with atomic operations, but makes
+/// those threads contend on them.
+///
+std::size_t n_thread_shards();
+
+/// The (assumed) size of a cache line, for aligning the shards to
+constexpr std::size_t cache_line_size = 64;
+
+/// Get a small, unique number identifying the current thread
+///
+/// Threads are numbered sequentially (starting from 1), in the order in
+/// which they first call this function.
+///
+std::size_t thread_number();
+
+/// Get the index of the statistics shard that the current thread should use
+///
+/// Threads are assigned to the shards in a round-robin fashion, based on
+/// their @c vecmem::details::thread_number().
+///
+std::size_t thread_shard_index();
+
+}  // namespace vecmem::details
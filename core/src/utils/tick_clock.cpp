@@ -0,0 +1,37 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// Local include(s).
+#include "tick_clock.hpp"
+
+namespace vecmem::details {
+
+double nanoseconds_per_tick() {
+
+    static const double result = []() {
+        using clock = std::chrono::steady_clock;
+        /*
+         * Count the ticks during a short, busy-waited interval.
+         */
+        const clock::time_point t1 = clock::now();
+        const std::uint64_t ticks1 = read_ticks();
+        clock::time_point t2 = clock::now();
+        while (t2 - t1 < std::chrono::milliseconds(2)) {
+            t2 = clock::now();
+        }
+        const std::uint64_t ticks2 = read_ticks();
+        const double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1)
+                .count());
+        return ((ticks2 > ticks1) ? ns / static_cast<double>(ticks2 - ticks1)
+                                  : 1.);
+    }();
+    return result;
+}
+
+}  // namespace vecmem::details
@@ -0,0 +1,61 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// System include(s).
+#include <chrono>
+#include <cstdint>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace vecmem::details {
+
+/// Read a cheap, monotonically increasing tick counter
+///
+/// Uses the time stamp counter of the CPU where one is available, and
+/// @c std::chrono::steady_clock (in nanoseconds) otherwise.
+///
+inline std::uint64_t read_ticks() {
+
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || \
+    defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t result;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(result));
+    return result;
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+}
+
+/// Read @c std::chrono::steady_clock, in nanoseconds
+inline std::uint64_t steady_nanoseconds() {
+
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/// Get the number of nanoseconds corresponding to one tick of
+/// @c vecmem::details::read_ticks()
+///
+/// The value is calibrated (against @c std::chrono::steady_clock) on the
+/// first call.
+///
+double nanoseconds_per_tick();
+
+}  // namespace vecmem::details
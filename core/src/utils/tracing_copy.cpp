@@ -0,0 +1,80 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// VecMem include(s).
+#include "vecmem/utils/tracing_copy.hpp"
+
+#include "thread_shard.hpp"
+#include "tick_clock.hpp"
+
+// System include(s).
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+/// Get the name of a copy type
+const char* type_name(vecmem::copy::type::copy_type cptype) {
+
+    switch (cptype) {
+        case vecmem::copy::type::host_to_device:
+            return "host_to_device";
+        case vecmem::copy::type::device_to_host:
+            return "device_to_host";
+        case vecmem::copy::type::host_to_host:
+            return "host_to_host";
+        case vecmem::copy::type::device_to_device:
+            return "device_to_device";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace
+
+namespace vecmem {
+
+tracing_copy::tracing_copy(copy& wrapped, chrome_trace_writer& writer)
+    : m_wrapped(wrapped), m_writer(writer) {}
+
+void tracing_copy::do_copy(std::size_t size, const void* from, void* to,
+                           type::copy_type cptype) {
+
+    // Perform the copy, timing it.
+    const std::uint64_t start = details::steady_nanoseconds();
+    m_wrapped.do_copy(size, from, to, cptype);
+    const std::uint64_t end = details::steady_nanoseconds();
+
+    // Write it into the trace.
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer),
+                  "\"size\":%zu,\"from\":\"%p\",\"to\":\"%p\","
+                  "\"kind\":\"%s\"",
+                  size, from, static_cast<const void*>(to), type_name(cptype));
+    m_writer.write_complete_event("copy", "copy", start, end - start,
+                                  details::thread_number(), buffer);
+}
+
+void tracing_copy::do_memset(std::size_t size, void* ptr, int value) {
+
+    // Perform the operation, timing it.
+    const std::uint64_t start = details::steady_nanoseconds();
+    m_wrapped.do_memset(size, ptr, value);
+    const std::uint64_t end = details::steady_nanoseconds();
+
+    // Write it into the trace.
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer),
+                  "\"size\":%zu,\"ptr\":\"%p\",\"value\":%i", size,
+                  static_cast<const void*>(ptr), value);
+    m_writer.write_complete_event("memset", "copy", start, end - start,
+                                  details::thread_number(), buffer);
+}
+
+}  // namespace vecmem
@@ -0,0 +1,25 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/memory_resource.hpp"
+
+// GoogleTest include(s).
+#include <gtest/gtest.h>
+
+/// Test case for the "stress tests" of thread-safe memory resources
+///
+/// It should only be instantiated for memory resources that can be used from
+/// multiple threads at the same time.
+///
+class memory_resource_test_concurrent
+    : public testing::TestWithParam<vecmem::memory_resource*> {};
+
+// Include the implementation.
+#include "memory_resource_test_concurrent.ipp"
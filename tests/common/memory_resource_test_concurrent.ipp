@@ -0,0 +1,91 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#pragma once
+
+// Local include(s).
+#include "vecmem/containers/vector.hpp"
+
+// System include(s).
+#include <random>
+#include <thread>
+#include <vector>
+
+/// Test that the memory resource would behave correctly with a large number
+/// of allocations/de-allocations coming from multiple threads at the same time.
+TEST_P(memory_resource_test_concurrent, stress_test) {
+
+    // The number of threads to use in the test.
+    static constexpr int N_THREADS = 4;
+
+    // Vectors created by each thread, to be destroyed by another thread.
+    std::vector<std::vector<vecmem::vector<int> > > handover(N_THREADS);
+
+    // Function performing the same sort of allocations as the single-threaded
+    // stress test, and then leaving a set of vectors behind.
+    auto allocate = [this, &handover](int thread) {
+        std::minstd_rand rng(thread + 1);
+        for (int i = 0; i < 100; ++i) {
+
+            // Fill a random number of vectors, with a random number of
+            // "constant" elements.
+            std::vector<vecmem::vector<int> > vectors;
+            const int n_vectors = static_cast<int>(rng() % 100);
+            for (int j = 0; j < n_vectors; ++j) {
+                vectors.emplace_back(GetParam());
+                const int n_elements = static_cast<int>(rng() % 100);
+                for (int k = 0; k < n_elements; ++k) {
+                    vectors.back().push_back(thread * 1000 + j);
+                }
+            }
+
+            // Check that all vectors have the intended content after all of
+            // this.
+            for (int j = 0; j < n_vectors; ++j) {
+                for (int value : vectors.at(j)) {
+                    EXPECT_EQ(value, thread * 1000 + j);
+                }
+            }
+
+            // Hand the vectors of the last iteration over to another thread.
+            if (i == 99) {
+                handover[thread] = std::move(vectors);
+            }
+        }
+    };
+
+    // Run the allocations in parallel.
+    std::vector<std::thread> threads;
+    for (int i = 0; i < N_THREADS; ++i) {
+        threads.emplace_back(allocate, i);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    threads.clear();
+
+    // Destroy the vectors left behind on a different thread than the one that
+    // created them.
+    auto deallocate = [&handover](int thread) {
+        std::vector<vecmem::vector<int> >& vectors =
+            handover[(thread + 1) % N_THREADS];
+        for (std::size_t j = 0; j < vectors.size(); ++j) {
+            for (int value : vectors[j]) {
+                EXPECT_EQ(value, ((thread + 1) % N_THREADS) * 1000 +
+                                     static_cast<int>(j));
+            }
+        }
+        vectors.clear();
+    };
+    for (int i = 0; i < N_THREADS; ++i) {
+        threads.emplace_back(deallocate, i);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
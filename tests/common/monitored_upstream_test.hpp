@@ -0,0 +1,34 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+#pragma once
+
+// Local include(s).
+#include "vecmem/memory/host_memory_resource.hpp"
+#include "vecmem/memory/instrumenting_memory_resource.hpp"
+#include "vecmem/utils/memory_monitor.hpp"
+
+// GoogleTest include(s).
+#include <gtest/gtest.h>
+
+/// Base test case for memory resources that get memory from an upstream one
+///
+/// It provides an instrumented host memory resource as the upstream of the
+/// tested resource, with a memory monitor attached to it. So that the tests
+/// can check how much memory the tested resource holds from upstream.
+///
+class monitored_upstream_test : public testing::Test {
+
+protected:
+    /// The base memory resource
+    vecmem::host_memory_resource m_host;
+    /// The upstream resource of the tested one, instrumenting the base
+    vecmem::instrumenting_memory_resource m_upstream{m_host};
+    /// Monitor of the requests made to the upstream resource
+    vecmem::memory_monitor m_monitor{m_upstream};
+
+};  // class monitored_upstream_test
@@ -0,0 +1,183 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../common/monitored_upstream_test.hpp"
+#include "vecmem/memory/arena_memory_resource.hpp"
+
+/// Test case for @c vecmem::arena_memory_resource
+class core_arena_memory_resource_test : public monitored_upstream_test {};
+
+TEST_F(core_arena_memory_resource_test, release_unused) {
+    vecmem::arena_memory_resource res(m_upstream, 65536, 10000000);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 65536);
+
+    // Allocate some small blocks from the initial superblock, and two large
+    // blocks that need superblocks of their own.
+    void* p1 = res.allocate(1000);
+    void* p2 = res.allocate(300000);
+    void* p3 = res.allocate(400000);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 65536 + 300032 + 400128);
+
+    // Nothing can be released while everything is in use.
+    EXPECT_EQ(res.release_unused(), 0);
+
+    // Free the large blocks, and release their superblocks.
+    res.deallocate(p2, 300000);
+    res.deallocate(p3, 400000);
+    EXPECT_EQ(res.release_unused(), 300032 + 400128);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 65536);
+
+    // The arena must still be functional.
+    p2 = res.allocate(2000);
+    res.deallocate(p2, 2000);
+    res.deallocate(p1, 1000);
+    EXPECT_EQ(res.release_unused(65536), 0);
+    EXPECT_EQ(res.release_unused(), 65536);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 0);
+
+    // And it should be able to grow again.
+    p1 = res.allocate(1000);
+    EXPECT_GT(m_monitor.outstanding_allocation(), 0);
+    res.deallocate(p1, 1000);
+}
+
+TEST_F(core_arena_memory_resource_test, release_watermarks) {
+    vecmem::arena_memory_resource res(m_upstream, 65536, 10000000);
+    res.set_release_watermarks(1000000, 65536);
+
+    // Allocate, and then free, a number of large blocks.
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < 4; ++i) {
+        ptrs.push_back(res.allocate(500000));
+    }
+    for (void* p : ptrs) {
+        res.deallocate(p, 500000);
+    }
+
+    // The resource must have given back memory on its own, but no more than
+    // what is needed to go below the low watermark.
+    EXPECT_LT(m_monitor.outstanding_allocation(), 65536 + 2 * 500224);
+    EXPECT_GE(m_monitor.outstanding_allocation(), 65536);
+}
+
+TEST_F(core_arena_memory_resource_test, random_free_order) {
+    vecmem::arena_memory_resource res(m_upstream, 1048576, 100000000);
+
+    // Make many allocations of various sizes, and fill each of them with a
+    // pattern of its own.
+    std::default_random_engine eng;
+    std::uniform_int_distribution<std::size_t> gen(1, 5000);
+    std::vector<std::pair<void*, std::size_t>> allocs(2000);
+    for (std::size_t i = 0; i < allocs.size(); ++i) {
+        allocs[i].second = gen(eng);
+        allocs[i].first = res.allocate(allocs[i].second);
+        ASSERT_NE(allocs[i].first, nullptr);
+        std::memset(allocs[i].first, static_cast<int>(i % 256),
+                    allocs[i].second);
+    }
+
+    // Free them in a random order, checking that no allocation overlapped
+    // with any other one.
+    std::vector<std::size_t> order(allocs.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), eng);
+    for (std::size_t i : order) {
+        auto const* bytes = static_cast<const unsigned char*>(allocs[i].first);
+        auto const pattern = static_cast<unsigned char>(i % 256);
+        EXPECT_TRUE(std::all_of(bytes, bytes + allocs[i].second,
+                                [pattern](unsigned char c) {
+                                    return c == pattern;
+                                }));
+        res.deallocate(allocs[i].first, allocs[i].second);
+    }
+
+    // Everything must have been coalesced back into entirely free
+    // superblocks.
+    const std::size_t outstanding = m_monitor.outstanding_allocation();
+    EXPECT_EQ(res.release_unused(), outstanding);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 0);
+}
+
+TEST_F(core_arena_memory_resource_test, multi_arena_cross_thread) {
+    vecmem::arena_memory_resource res(m_upstream, 1048576, 100000000, 4);
+
+    // Allocate blocks on a number of threads, small and large ones.
+    static constexpr std::size_t n_threads = 4;
+    static constexpr std::size_t n_allocs = 1000;
+    std::vector<std::vector<std::pair<void*, std::size_t>>> allocs(n_threads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&res, &allocs, t]() {
+            for (std::size_t i = 0; i < n_allocs; ++i) {
+                const std::size_t size = (i % 100 == 0 ? 300000 : 100 + i);
+                allocs[t].emplace_back(res.allocate(size), size);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Free all of them from other threads than the ones that allocated them.
+    threads.clear();
+    for (std::size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&res, &allocs, t]() {
+            for (auto& a : allocs[(t + 1) % n_threads]) {
+                res.deallocate(a.first, a.second);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // All memory must be returned to the upstream resource on request.
+    res.release_unused();
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 0);
+}
+
+TEST_F(core_arena_memory_resource_test, owns) {
+    using ownership = vecmem::arena_memory_resource::ownership;
+
+    vecmem::arena_memory_resource single(m_upstream, 65536, 10000000);
+    vecmem::arena_memory_resource multi(m_upstream, 65536, 10000000, 4);
+
+    for (vecmem::arena_memory_resource* res : {&single, &multi}) {
+
+        // Small blocks come from the initial superblock, large ones from
+        // superblocks of their own.
+        char* small = static_cast<char*>(res->allocate(256));
+        char* large = static_cast<char*>(res->allocate(1000000));
+        EXPECT_EQ(res->owns(small), ownership::owned);
+        EXPECT_EQ(res->owns(small + 255), ownership::owned);
+        EXPECT_EQ(res->owns(large), ownership::owned);
+        EXPECT_EQ(res->owns(large + 999999), ownership::owned);
+
+        // Memory from elsewhere is not claimed.
+        int on_stack = 0;
+        void* on_host = m_host.allocate(1024);
+        EXPECT_EQ(res->owns(&on_stack), ownership::not_owned);
+        EXPECT_EQ(res->owns(on_host), ownership::not_owned);
+        m_host.deallocate(on_host, 1024);
+
+        res->deallocate(small, 256);
+        res->deallocate(large, 1000000);
+    }
+}
@@ -0,0 +1,258 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "vecmem/memory/binary_page_memory_resource.hpp"
+#include "vecmem/memory/host_memory_resource.hpp"
+#include "vecmem/memory/instrumenting_memory_resource.hpp"
+#include "vecmem/utils/memory_monitor.hpp"
+
+class core_binary_page_memory_resource_test : public testing::Test {
+protected:
+    vecmem::host_memory_resource m_host;
+    vecmem::instrumenting_memory_resource m_upstream{m_host};
+
+    /// Count the number of allocations made from the upstream resource
+    std::size_t upstream_allocations() const {
+        std::size_t result = 0;
+        for (const auto& e : m_upstream.get_events()) {
+            if (e.m_type == vecmem::instrumenting_memory_resource::
+                                memory_event::type::ALLOCATION) {
+                ++result;
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(core_binary_page_memory_resource_test, reuse_after_coalescing) {
+    vecmem::binary_page_memory_resource res(m_upstream);
+
+    // Fill up a full superpage with the smallest possible pages.
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < 1024; ++i) {
+        ptrs.push_back(res.allocate(1024));
+    }
+
+    EXPECT_EQ(upstream_allocations(), 1);
+
+    // Free them in an interleaved order.
+    for (std::size_t i = 0; i < ptrs.size(); i += 2) {
+        res.deallocate(ptrs[i], 1024);
+    }
+    for (std::size_t i = 1; i < ptrs.size(); i += 2) {
+        res.deallocate(ptrs[i], 1024);
+    }
+
+    // The freed pages must have been merged back into a single page, which
+    // can serve a request for the full superpage.
+    void* p = res.allocate(1048576);
+    EXPECT_EQ(p, ptrs[0]);
+    EXPECT_EQ(upstream_allocations(), 1);
+
+    res.deallocate(p, 1048576);
+}
+
+TEST_F(core_binary_page_memory_resource_test, mixed_sizes) {
+    vecmem::binary_page_memory_resource res(m_upstream);
+
+    // Allocate pages of various sizes, including ones larger than the default
+    // superpage size.
+    std::vector<std::pair<void*, std::size_t>> allocs;
+    for (std::size_t size : {1000, 5000, 3000000, 1024, 70000, 2048, 500000}) {
+        void* p = res.allocate(size);
+        std::memset(p, 0xab, size);
+        allocs.emplace_back(p, size);
+    }
+
+    // Make sure that no two allocations overlap.
+    for (std::size_t i = 0; i < allocs.size(); ++i) {
+        for (std::size_t j = i + 1; j < allocs.size(); ++j) {
+            const char* bi = static_cast<const char*>(allocs[i].first);
+            const char* bj = static_cast<const char*>(allocs[j].first);
+            EXPECT_TRUE(bi + allocs[i].second <= bj ||
+                        bj + allocs[j].second <= bi);
+        }
+    }
+
+    for (const auto& a : allocs) {
+        res.deallocate(a.first, a.second);
+    }
+}
+
+TEST_F(core_binary_page_memory_resource_test, release_unused) {
+    vecmem::memory_monitor monitor(m_upstream);
+    vecmem::binary_page_memory_resource res(m_upstream);
+
+    // Allocate a couple of superpages' worth of memory.
+    void* p1 = res.allocate(1048576);
+    void* p2 = res.allocate(1048576);
+    void* p3 = res.allocate(1000);
+    EXPECT_EQ(monitor.outstanding_allocation(), 3 * 1048576);
+
+    // Nothing can be released while everything is in use.
+    EXPECT_EQ(res.release_unused(), 0);
+
+    // Free the superpages, and check that they are only released on request.
+    res.deallocate(p1, 1048576);
+    res.deallocate(p2, 1048576);
+    EXPECT_EQ(monitor.outstanding_allocation(), 3 * 1048576);
+    EXPECT_EQ(res.release_unused(1048576), 1048576);
+    EXPECT_EQ(monitor.outstanding_allocation(), 2 * 1048576);
+    EXPECT_EQ(res.release_unused(), 1048576);
+    EXPECT_EQ(monitor.outstanding_allocation(), 1048576);
+
+    // The memory resource must still be functional.
+    p1 = res.allocate(2000);
+    res.deallocate(p1, 2000);
+    res.deallocate(p3, 1000);
+    EXPECT_EQ(res.release_unused(), 1048576);
+    EXPECT_EQ(monitor.outstanding_allocation(), 0);
+}
+
+TEST_F(core_binary_page_memory_resource_test, release_watermarks) {
+    vecmem::memory_monitor monitor(m_upstream);
+    vecmem::binary_page_memory_resource res(m_upstream);
+    res.set_release_watermarks(2 * 1048576, 1048576);
+
+    // Allocate, and then free, four superpages.
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < 4; ++i) {
+        ptrs.push_back(res.allocate(1048576));
+    }
+    for (void* p : ptrs) {
+        res.deallocate(p, 1048576);
+    }
+
+    // After the third superpage became vacant, the resource should have gone
+    // down to one vacant superpage. With the fourth one freed, there should
+    // be two left.
+    EXPECT_EQ(monitor.outstanding_allocation(), 2 * 1048576);
+}
+
+TEST_F(core_binary_page_memory_resource_test, owns) {
+    using ownership = vecmem::binary_page_memory_resource::ownership;
+
+    vecmem::binary_page_memory_resource unsharded(m_upstream);
+    vecmem::binary_page_memory_resource sharded(m_upstream, 4);
+
+    for (vecmem::binary_page_memory_resource* res : {&unsharded, &sharded}) {
+
+        // Memory handed out by the resource is claimed by it, including the
+        // end of the allocations.
+        std::vector<std::pair<char*, std::size_t>> allocs;
+        for (std::size_t size : {16UL, 1000UL, 100000UL, 5000000UL}) {
+            allocs.emplace_back(static_cast<char*>(res->allocate(size)),
+                                size);
+        }
+        for (const auto& a : allocs) {
+            EXPECT_EQ(res->owns(a.first), ownership::owned);
+            EXPECT_EQ(res->owns(a.first + a.second - 1), ownership::owned);
+        }
+
+        // Memory from elsewhere is not.
+        int on_stack = 0;
+        void* on_host = m_host.allocate(1024);
+        EXPECT_EQ(res->owns(&on_stack), ownership::not_owned);
+        EXPECT_EQ(res->owns(on_host), ownership::not_owned);
+        m_host.deallocate(on_host, 1024);
+
+        for (const auto& a : allocs) {
+            res->deallocate(a.first, a.second);
+        }
+    }
+}
+
+// The page states are stored 32 to a 64-bit word, and scanned a word at a
+// time. The following tests exercise that packing through the allocation
+// pattern of a single 1 MiB superpage. Its 1 KiB pages are the nodes with
+// indices [1023, 2047) of the page tree.
+
+TEST_F(core_binary_page_memory_resource_test, lowest_index_selection) {
+    vecmem::binary_page_memory_resource res(m_upstream);
+
+    // Pages of a fresh superpage are handed out from left to right.
+    std::vector<char*> ptrs;
+    for (std::size_t i = 0; i < 64; ++i) {
+        ptrs.push_back(static_cast<char*>(res.allocate(1024)));
+    }
+    for (std::size_t i = 1; i < ptrs.size(); ++i) {
+        EXPECT_EQ(ptrs[i], ptrs[0] + i * 1024);
+    }
+
+    // Free a few pages inside of a single word of states (nodes 1056-1087).
+    // The lowest one of them must be picked first.
+    for (std::size_t i : {60u, 45u, 40u, 50u}) {
+        res.deallocate(ptrs[i], 1024);
+    }
+    for (std::size_t i : {40u, 45u, 50u, 60u}) {
+        EXPECT_EQ(res.allocate(1024), ptrs[i]);
+    }
+
+    for (char* p : ptrs) {
+        res.deallocate(p, 1024);
+    }
+}
+
+TEST_F(core_binary_page_memory_resource_test, word_boundary_pages) {
+    vecmem::binary_page_memory_resource res(m_upstream);
+
+    // The first two 1 KiB pages are nodes 1023 and 1024. They are buddies,
+    // but their states are stored in different words.
+    char* p1 = static_cast<char*>(res.allocate(1024));
+    char* p2 = static_cast<char*>(res.allocate(1024));
+    char* p3 = static_cast<char*>(res.allocate(1024));
+    EXPECT_EQ(p2, p1 + 1024);
+    EXPECT_EQ(p3, p2 + 1024);
+
+    // Freeing the second page must make it available, across the boundary.
+    res.deallocate(p2, 1024);
+    EXPECT_EQ(res.allocate(1024), p2);
+
+    // Freeing both must merge them back into their 2 KiB parent.
+    res.deallocate(p1, 1024);
+    res.deallocate(p2, 1024);
+    EXPECT_EQ(res.allocate(2048), p1);
+    EXPECT_EQ(upstream_allocations(), 1);
+
+    res.deallocate(p1, 2048);
+    res.deallocate(p3, 1024);
+}
+
+TEST_F(core_binary_page_memory_resource_test, superpage_padding) {
+    vecmem::binary_page_memory_resource res(m_upstream);
+
+    // The 2047 nodes of the superpage do not fill the last word of states.
+    // Its padding must never be picked as a vacant page, which would be
+    // right past the end of the superpage.
+    // The last of these pages is the last node of the tree.
+    std::vector<char*> ptrs;
+    for (std::size_t i = 0; i < 1024; ++i) {
+        ptrs.push_back(static_cast<char*>(res.allocate(1024)));
+    }
+    EXPECT_EQ(upstream_allocations(), 1);
+    for (std::size_t i = 1; i < ptrs.size(); ++i) {
+        EXPECT_EQ(ptrs[i], ptrs[0] + i * 1024);
+    }
+
+    // A full superpage has to make the next allocation go upstream.
+    char* p = static_cast<char*>(res.allocate(1024));
+    EXPECT_EQ(upstream_allocations(), 2);
+    EXPECT_TRUE((p < ptrs[0]) || (p >= ptrs[0] + 1048576));
+
+    res.deallocate(p, 1024);
+    for (char* ptr : ptrs) {
+        res.deallocate(ptr, 1024);
+    }
+}
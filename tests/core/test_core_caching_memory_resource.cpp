@@ -0,0 +1,111 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "../common/monitored_upstream_test.hpp"
+#include "vecmem/memory/caching_memory_resource.hpp"
+
+/// Test case for @c vecmem::caching_memory_resource
+class core_caching_memory_resource_test : public monitored_upstream_test {};
+
+TEST_F(core_caching_memory_resource_test, event_loop) {
+    vecmem::caching_memory_resource res(m_upstream);
+
+    // Allocate, and then free, the same set of buffers a few times.
+    static const std::vector<std::size_t> sizes = {100, 1000, 1000, 5000,
+                                                   100000};
+    for (std::size_t event = 0; event < 5; ++event) {
+        std::vector<void*> ptrs;
+        for (std::size_t size : sizes) {
+            ptrs.push_back(res.allocate(size));
+        }
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            res.deallocate(ptrs[i], sizes[i]);
+        }
+    }
+
+    // Only the first event should have needed upstream allocations, of the
+    // bin sizes.
+    EXPECT_EQ(res.cache_misses(), sizes.size());
+    EXPECT_EQ(res.cache_hits(), 4 * sizes.size());
+    EXPECT_EQ(m_monitor.total_allocation(), 256 + 2 * 1024 + 8192 + 131072);
+    EXPECT_EQ(res.cached_bytes(), m_monitor.outstanding_allocation());
+
+    // Everything must be given back to upstream on request.
+    EXPECT_EQ(res.release_unused(), 256 + 2 * 1024 + 8192 + 131072);
+    EXPECT_EQ(res.cached_bytes(), 0);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 0);
+}
+
+TEST_F(core_caching_memory_resource_test, alignment) {
+    vecmem::caching_memory_resource res(m_upstream);
+
+    // Blocks must only be re-used for requests of the same alignment.
+    void* p1 = res.allocate(1000, 64);
+    res.deallocate(p1, 1000, 64);
+    void* p2 = res.allocate(1000, 128);
+    EXPECT_EQ(res.cache_hits(), 0);
+    void* p3 = res.allocate(1000, 64);
+    EXPECT_EQ(p3, p1);
+    EXPECT_EQ(res.cache_hits(), 1);
+    res.deallocate(p2, 1000, 128);
+    res.deallocate(p3, 1000, 64);
+}
+
+TEST_F(core_caching_memory_resource_test, lru_eviction) {
+    vecmem::caching_memory_resource res(m_upstream, 4096, 2, 256, 65536);
+
+    // Free more blocks than what fits into the cache.
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < 6; ++i) {
+        ptrs.push_back(res.allocate(1024));
+    }
+    for (void* p : ptrs) {
+        res.deallocate(p, 1024);
+    }
+    EXPECT_EQ(res.cached_bytes(), 4096);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 4096);
+
+    // The least recently freed blocks must have been evicted, and the most
+    // recently freed one should be handed out first.
+    EXPECT_EQ(res.allocate(1024), ptrs[5]);
+    res.deallocate(ptrs[5], 1024);
+
+    // Blocks larger than the largest bin are never cached.
+    void* p = res.allocate(100000);
+    res.deallocate(p, 100000);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 4096);
+}
+
+TEST_F(core_caching_memory_resource_test, largest_bin) {
+    vecmem::caching_memory_resource res(m_upstream, 4096, 2, 256, 1000);
+
+    // Allocations in the largest bin must not be larger than the bin.
+    void* p = res.allocate(1000);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 1000);
+    res.deallocate(p, 1000);
+    EXPECT_EQ(res.cached_bytes(), 1000);
+    EXPECT_EQ(res.allocate(600), p);
+    res.deallocate(p, 600);
+
+    // A largest bin size close to the limit of std::size_t must not make the
+    // bin sizes overflow.
+    vecmem::caching_memory_resource huge(m_upstream, 4096, 2, 256,
+                                         static_cast<std::size_t>(-1));
+    p = huge.allocate(1000);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 1000 + 1024);
+    huge.deallocate(p, 1000);
+    EXPECT_EQ(huge.cached_bytes(), 1024);
+    EXPECT_THROW(p = huge.allocate(static_cast<std::size_t>(-1) - 1),
+                 std::bad_alloc);
+}
@@ -8,6 +8,10 @@
 
 #include <gtest/gtest.h>
 
+#include <utility>
+#include <vector>
+
+#include "vecmem/memory/binary_page_memory_resource.hpp"
 #include "vecmem/memory/choice_memory_resource.hpp"
 #include "vecmem/memory/host_memory_resource.hpp"
 #include "vecmem/memory/instrumenting_memory_resource.hpp"
@@ -65,3 +69,39 @@ TEST(core_choice_memory_resource_test, allocate) {
 
     EXPECT_THROW(p = res.allocate(512, 32), std::bad_alloc);
 }
+
+TEST(core_choice_memory_resource_test, route_by_ownership) {
+    vecmem::host_memory_resource ups;
+
+    // Small allocations go to a pool that can tell which memory it owns,
+    // large ones to a resource that can not.
+    vecmem::binary_page_memory_resource pool(ups);
+    vecmem::instrumenting_memory_resource large(ups);
+
+    std::size_t pool_allocs = 0;
+    std::size_t large_deallocs = 0;
+    large.add_pre_deallocate_hook(
+        [&large_deallocs](void*, std::size_t, std::size_t) {
+            ++large_deallocs;
+        });
+
+    vecmem::choice_memory_resource res(
+        [&pool, &large, &pool_allocs](
+            std::size_t s, std::size_t) -> vecmem::memory_resource& {
+            if (s < 4096) {
+                ++pool_allocs;
+                return pool;
+            }
+            return large;
+        });
+
+    std::vector<std::pair<void*, std::size_t>> ptrs;
+    for (std::size_t size : {16UL, 100000UL, 1024UL, 8192UL, 2048UL}) {
+        ptrs.emplace_back(res.allocate(size), size);
+    }
+    EXPECT_EQ(pool_allocs, 3u);
+    for (const auto& p : ptrs) {
+        res.deallocate(p.first, p.second);
+    }
+    EXPECT_EQ(large_deallocs, 2u);
+}
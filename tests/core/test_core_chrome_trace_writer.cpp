@@ -0,0 +1,150 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// VecMem include(s).
+#include "vecmem/containers/vector.hpp"
+#include "vecmem/memory/host_memory_resource.hpp"
+#include "vecmem/memory/instrumenting_memory_resource.hpp"
+#include "vecmem/utils/chrome_trace_writer.hpp"
+#include "vecmem/utils/copy.hpp"
+#include "vecmem/utils/tracing_copy.hpp"
+
+// GoogleTest include(s).
+#include <gtest/gtest.h>
+
+// System include(s).
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace {
+
+/// Count the occurrences of a string in a trace
+std::size_t count(const std::string& trace, const std::string& what) {
+
+    std::size_t result = 0;
+    for (std::size_t pos = trace.find(what); pos != std::string::npos;
+         pos = trace.find(what, pos + what.size())) {
+        ++result;
+    }
+    return result;
+}
+
+/// Check the overall structure of a finished trace
+void check_structure(const std::string& trace) {
+
+    EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["),
+              0u);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    EXPECT_EQ(std::count(trace.begin(), trace.end(), '{'),
+              std::count(trace.begin(), trace.end(), '}'));
+}
+
+}  // namespace
+
+TEST(core_chrome_trace_writer_test, recorded_events) {
+
+    vecmem::host_memory_resource upstream;
+    vecmem::instrumenting_memory_resource resource(upstream);
+
+    void* p1 = resource.allocate(128);
+    void* p2 = resource.allocate(1024, 64);
+    resource.deallocate(p1, 128);
+    resource.deallocate(p2, 1024, 64);
+
+    // The events must know where and when they happened.
+    const auto events = resource.get_events();
+    ASSERT_EQ(events.size(), 4u);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        EXPECT_GT(events[i].m_thread, 0u);
+        EXPECT_GT(events[i].m_start, 0u);
+        if (i > 0) {
+            EXPECT_GE(events[i].m_start, events[i - 1].m_start);
+        }
+    }
+
+    std::ostringstream out;
+    {
+        vecmem::chrome_trace_writer writer(out);
+        writer.write(resource, "host \"pool\"");
+    }
+    const std::string trace = out.str();
+    check_structure(trace);
+
+    EXPECT_EQ(count(trace, "\"ph\":\"X\""), 4u);
+    EXPECT_EQ(count(trace, "\"name\":\"allocate\""), 2u);
+    EXPECT_EQ(count(trace, "\"name\":\"deallocate\""), 2u);
+    EXPECT_EQ(count(trace, "\"resource\":\"host \\\"pool\\\"\""), 4u);
+    EXPECT_EQ(count(trace, "\"size\":1024,\"align\":64"), 2u);
+
+    // The counter of the held memory must go up, and back down to zero.
+    EXPECT_EQ(count(trace, "\"ph\":\"C\""), 4u);
+    EXPECT_EQ(count(trace, "\"bytes\":128}"), 1u);
+    EXPECT_EQ(count(trace, "\"bytes\":1152}"), 1u);
+    EXPECT_EQ(count(trace, "\"bytes\":1024}"), 1u);
+    EXPECT_EQ(count(trace, "\"bytes\":0}"), 1u);
+}
+
+TEST(core_chrome_trace_writer_test, attach) {
+
+    // The resource does not keep any events itself.
+    vecmem::host_memory_resource upstream;
+    vecmem::instrumenting_memory_resource resource(
+        upstream, vecmem::instrumenting_memory_resource::recording::aggregate);
+
+    std::ostringstream out;
+    vecmem::chrome_trace_writer writer(out);
+    writer.attach(resource, "host");
+
+    void* p = resource.allocate(256);
+    resource.deallocate(p, 256);
+    writer.close();
+
+    // Events after closing the trace are ignored.
+    p = resource.allocate(256);
+    resource.deallocate(p, 256);
+
+    const std::string trace = out.str();
+    check_structure(trace);
+    EXPECT_EQ(count(trace, "\"ph\":\"X\""), 2u);
+    EXPECT_EQ(count(trace, "\"cat\":\"memory\""), 2u);
+    EXPECT_EQ(count(trace, "\"size\":256"), 2u);
+    EXPECT_EQ(count(trace, "\"bytes\":256}"), 1u);
+}
+
+TEST(core_chrome_trace_writer_test, tracing_copy) {
+
+    vecmem::host_memory_resource resource;
+    vecmem::copy base_copy;
+
+    std::ostringstream out;
+    {
+        vecmem::chrome_trace_writer writer(out);
+        vecmem::tracing_copy copy(base_copy, writer);
+
+        vecmem::vector<int> source = {{1, 2, 3, 4, 5}, &resource};
+        vecmem::vector<int> target(&resource);
+        copy(vecmem::get_data(source), target,
+             vecmem::copy::type::host_to_host);
+        EXPECT_EQ(source, target);
+
+        auto target_data = vecmem::get_data(target);
+        copy.memset(target_data, 0);
+        for (int value : target) {
+            EXPECT_EQ(value, 0);
+        }
+    }
+    const std::string trace = out.str();
+    check_structure(trace);
+    EXPECT_EQ(count(trace, "\"cat\":\"copy\""), 2u);
+    EXPECT_EQ(count(trace, "\"name\":\"copy\""), 1u);
+    EXPECT_EQ(count(trace, "\"name\":\"memset\""), 1u);
+    EXPECT_EQ(count(trace, "\"size\":20,"), 2u);
+    EXPECT_EQ(count(trace, "\"kind\":\"host_to_host\""), 1u);
+}
@@ -8,8 +8,12 @@
 
 #include <gtest/gtest.h>
 
+#include <utility>
+#include <vector>
+
 #include "vecmem/memory/coalescing_memory_resource.hpp"
 #include "vecmem/memory/conditional_memory_resource.hpp"
+#include "vecmem/memory/contiguous_memory_resource.hpp"
 #include "vecmem/memory/host_memory_resource.hpp"
 #include "vecmem/memory/instrumenting_memory_resource.hpp"
 #include "vecmem/memory/memory_resource.hpp"
@@ -104,3 +108,142 @@ TEST(core_coalescing_memory_resource_test, allocate_complex) {
 
     EXPECT_THROW(p = res.allocate(131072), std::bad_alloc);
 }
+
+TEST(core_coalescing_memory_resource_test, route_by_ownership) {
+    vecmem::host_memory_resource ups;
+
+    // A small pool, able to tell which memory it owns, and a fallback that
+    // can not.
+    vecmem::contiguous_memory_resource pool(ups, 4096);
+    vecmem::instrumenting_memory_resource fallback(ups);
+
+    std::size_t fallback_deallocs = 0;
+    fallback.add_pre_deallocate_hook(
+        [&fallback_deallocs](void *, std::size_t, std::size_t) {
+            ++fallback_deallocs;
+        });
+
+    vecmem::coalescing_memory_resource res({pool, fallback});
+
+    // Allocate more than what fits into the pool.
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 8; ++i) {
+        ptrs.push_back(res.allocate(1024));
+    }
+    EXPECT_EQ(pool.owns(ptrs.front()),
+              vecmem::contiguous_memory_resource::ownership::owned);
+    EXPECT_EQ(pool.owns(ptrs.back()),
+              vecmem::contiguous_memory_resource::ownership::not_owned);
+
+    // Only the memory not owned by the pool should reach the fallback.
+    std::size_t expected_fallback_deallocs = 0;
+    for (void *p : ptrs) {
+        if (pool.owns(p) !=
+            vecmem::contiguous_memory_resource::ownership::owned) {
+            ++expected_fallback_deallocs;
+        }
+        res.deallocate(p, 1024);
+    }
+    EXPECT_EQ(fallback_deallocs, expected_fallback_deallocs);
+    EXPECT_GT(fallback_deallocs, 0u);
+}
+
+TEST(core_coalescing_memory_resource_test, try_allocate) {
+    vecmem::terminal_memory_resource ter;
+    vecmem::host_memory_resource ups;
+    vecmem::conditional_memory_resource con(
+        ups, [](std::size_t s, std::size_t) { return s < 1024; });
+
+    // Failing allocations are signalled with a null pointer.
+    EXPECT_EQ(ter.try_allocate(1024), nullptr);
+    EXPECT_EQ(con.try_allocate(1024), nullptr);
+
+    vecmem::coalescing_memory_resource res({ter, con, ter});
+    EXPECT_EQ(res.try_allocate(1024), nullptr);
+
+    void *p = res.try_allocate(512);
+    EXPECT_NE(p, nullptr);
+    res.deallocate(p, 512);
+}
+
+TEST(core_coalescing_memory_resource_test, skip_failing_upstreams) {
+    vecmem::host_memory_resource ups;
+
+    // A small pool that can not tell in advance that it is full, and a
+    // fallback.
+    vecmem::contiguous_memory_resource pool(ups, 4096);
+    vecmem::instrumenting_memory_resource mon(pool);
+
+    std::size_t pool_attempts = 0;
+    mon.add_pre_allocate_hook(
+        [&pool_attempts](std::size_t, std::size_t) { ++pool_attempts; });
+
+    vecmem::coalescing_memory_resource res({mon, ups});
+
+    // Fill the pool.
+    std::vector<std::pair<void *, std::size_t>> ptrs;
+    for (int i = 0; i < 4; ++i) {
+        ptrs.emplace_back(res.allocate(1024), 1024);
+    }
+    EXPECT_EQ(pool_attempts, 4u);
+
+    // The first allocation not fitting into the pool should try it, later
+    // ones of the same or larger sizes should not.
+    ptrs.emplace_back(res.allocate(1024), 1024);
+    EXPECT_EQ(pool_attempts, 5u);
+    ptrs.emplace_back(res.allocate(1024), 1024);
+    ptrs.emplace_back(res.allocate(2048), 2048);
+    EXPECT_EQ(pool_attempts, 5u);
+
+    // Smaller allocations should still be attempted.
+    ptrs.emplace_back(res.allocate(16), 16);
+    EXPECT_EQ(pool_attempts, 6u);
+
+    // Once memory is returned to the pool, it should be tried again.
+    res.deallocate(ptrs.front().first, ptrs.front().second);
+    ptrs.erase(ptrs.begin());
+    ptrs.emplace_back(res.allocate(1024), 1024);
+    EXPECT_EQ(pool_attempts, 7u);
+
+    for (const auto &p : ptrs) {
+        res.deallocate(p.first, p.second);
+    }
+}
+
+TEST(core_coalescing_memory_resource_test, retry_only_skipped_upstreams) {
+    vecmem::host_memory_resource ups;
+
+    // Two small pools, without a fallback.
+    vecmem::contiguous_memory_resource pool1(ups, 4096);
+    vecmem::contiguous_memory_resource pool2(ups, 4096);
+    vecmem::instrumenting_memory_resource mon1(pool1);
+    vecmem::instrumenting_memory_resource mon2(pool2);
+
+    std::size_t attempts1 = 0, attempts2 = 0;
+    mon1.add_pre_allocate_hook(
+        [&attempts1](std::size_t, std::size_t) { ++attempts1; });
+    mon2.add_pre_allocate_hook(
+        [&attempts2](std::size_t, std::size_t) { ++attempts2; });
+
+    vecmem::coalescing_memory_resource res({mon1, mon2});
+
+    // Fill both pools. The first one is skipped once it failed.
+    std::vector<void *> ptrs;
+    for (int i = 0; i < 8; ++i) {
+        ptrs.push_back(res.allocate(1024));
+    }
+    EXPECT_EQ(attempts1, 5u);
+    EXPECT_EQ(attempts2, 4u);
+
+    // The skipped pool should get another chance, but the one that just
+    // failed should not be asked twice.
+    void *p = nullptr;
+    EXPECT_THROW(p = res.allocate(1024), std::bad_alloc);
+    EXPECT_EQ(p, nullptr);
+    EXPECT_EQ(attempts1, 6u);
+    EXPECT_EQ(attempts2, 5u);
+
+    for (void *ptr : ptrs) {
+        res.deallocate(ptr, 1024);
+    }
+}
@@ -9,12 +9,19 @@
 #include "vecmem/containers/vector.hpp"
 #include "vecmem/memory/contiguous_memory_resource.hpp"
 #include "vecmem/memory/host_memory_resource.hpp"
+#include "vecmem/memory/instrumenting_memory_resource.hpp"
+#include "vecmem/utils/memory_monitor.hpp"
 
 // GoogleTest include(s).
 #include <gtest/gtest.h>
 
 // System include(s).
+#include <algorithm>
 #include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 /// Test case for @c vecmem::contiguous_memory_resource
 class core_contiguous_memory_resource_test : public testing::Test {
@@ -61,3 +68,158 @@ TEST_F(core_contiguous_memory_resource_test, allocations) {
 
 #endif  // MSVC debug build...
 }
+
+/// Test going back to earlier positions in the memory blob
+TEST_F(core_contiguous_memory_resource_test, mark_and_rewind) {
+
+    // Allocate some memory that should stay in use.
+    void* p1 = m_resource.allocate(1000);
+    const vecmem::contiguous_memory_resource::marker m = m_resource.mark();
+
+    // Allocate some "scratch" memory a few times, going back to the marker
+    // every time.
+    void* p2 = m_resource.allocate(50000);
+    EXPECT_GE(static_cast<char*>(p2), static_cast<char*>(p1) + 1000);
+    for (int i = 0; i < 100; ++i) {
+        m_resource.rewind(m);
+        EXPECT_EQ(m_resource.allocate(50000), p2);
+    }
+
+    // Resetting the resource should make all of its memory available again.
+    void* p = nullptr;
+    EXPECT_THROW(p = m_resource.allocate(1048576), std::bad_alloc);
+    m_resource.reset();
+    EXPECT_EQ(m_resource.allocate(1048576), p1);
+    EXPECT_THROW(p = m_resource.allocate(1), std::bad_alloc);
+    EXPECT_EQ(p, nullptr);
+}
+
+/// Test allocating memory from multiple threads at the same time
+TEST_F(core_contiguous_memory_resource_test, concurrent_allocations) {
+
+    static constexpr std::size_t N_THREADS = 4;
+    static constexpr std::size_t N_ALLOCS = 1000;
+    static constexpr std::size_t ALLOC_SIZE = 64;
+
+    // Allocate memory from a number of threads.
+    std::vector<std::vector<char*>> ptrs(N_THREADS);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < N_THREADS; ++t) {
+        threads.emplace_back([this, &ptrs, t]() {
+            for (std::size_t i = 0; i < N_ALLOCS; ++i) {
+                ptrs[t].push_back(
+                    static_cast<char*>(m_resource.allocate(ALLOC_SIZE)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // None of the allocations may overlap.
+    std::vector<char*> all;
+    for (const std::vector<char*>& p : ptrs) {
+        all.insert(all.end(), p.begin(), p.end());
+    }
+    std::sort(all.begin(), all.end());
+    for (std::size_t i = 1; i < all.size(); ++i) {
+        EXPECT_GE(all[i], all[i - 1] + ALLOC_SIZE);
+    }
+}
+
+/// Test the growable mode of the memory resource
+TEST_F(core_contiguous_memory_resource_test, growable) {
+
+    vecmem::instrumenting_memory_resource upstream(m_upstream);
+    vecmem::memory_monitor monitor(upstream);
+    vecmem::contiguous_memory_resource resource(upstream, 1024, 2);
+    EXPECT_EQ(monitor.outstanding_allocation(), 1024);
+
+    // Allocate more memory than what fits into the first chunk. New chunks
+    // should be allocated with geometrically growing sizes.
+    for (int i = 0; i < 10; ++i) {
+        void* p = resource.allocate(500);
+        EXPECT_NE(p, nullptr);
+    }
+    EXPECT_EQ(monitor.outstanding_allocation(), 1024 + 2048 + 4096);
+
+    // Allocations larger than the next chunk size must also be possible.
+    void* p = resource.allocate(100000);
+    EXPECT_NE(p, nullptr);
+    EXPECT_GE(monitor.outstanding_allocation(), 1024 + 2048 + 4096 + 100000);
+
+    // Rewinding should keep all chunks, and re-use them.
+    const std::size_t outstanding = monitor.outstanding_allocation();
+    resource.rewind({0, 0});
+    for (int i = 0; i < 10; ++i) {
+        void* p2 = resource.allocate(500);
+        EXPECT_NE(p2, nullptr);
+    }
+    EXPECT_EQ(monitor.outstanding_allocation(), outstanding);
+
+    // Resetting should give back all chunks but the first one.
+    const vecmem::contiguous_memory_resource::marker m = resource.mark();
+    EXPECT_GT(m.m_chunk, 0);
+    resource.reset();
+    EXPECT_EQ(monitor.outstanding_allocation(), 1024);
+    EXPECT_EQ(resource.mark().m_chunk, 0);
+    EXPECT_EQ(resource.mark().m_offset, 0);
+
+    // Markers of the given back chunks must not be usable anymore.
+    EXPECT_THROW(resource.rewind(m), std::invalid_argument);
+    EXPECT_THROW(resource.rewind({0, 1025}), std::invalid_argument);
+    resource.rewind({0, 1024});
+}
+
+/// Test the address range based ownership checks
+TEST_F(core_contiguous_memory_resource_test, owns) {
+
+    using ownership = vecmem::contiguous_memory_resource::ownership;
+
+    // Set up a growable resource, and make it allocate a few chunks.
+    vecmem::contiguous_memory_resource resource(m_upstream, 1024, 2);
+    std::vector<char*> ptrs;
+    for (int i = 0; i < 10; ++i) {
+        ptrs.push_back(static_cast<char*>(resource.allocate(500)));
+    }
+
+    // All of the allocations are claimed by the resource.
+    for (char* p : ptrs) {
+        EXPECT_EQ(resource.owns(p), ownership::owned);
+        EXPECT_EQ(resource.owns(p + 499), ownership::owned);
+    }
+
+    // Memory from elsewhere is not.
+    int on_stack = 0;
+    void* on_host = m_upstream.allocate(1024);
+    EXPECT_EQ(resource.owns(&on_stack), ownership::not_owned);
+    EXPECT_EQ(resource.owns(on_host), ownership::not_owned);
+    EXPECT_EQ(m_resource.owns(on_host), ownership::not_owned);
+    m_upstream.deallocate(on_host, 1024);
+
+    // After a reset only the first chunk belongs to the resource anymore.
+    resource.reset();
+    EXPECT_EQ(resource.owns(ptrs.front()), ownership::owned);
+    EXPECT_EQ(resource.owns(ptrs.back()), ownership::not_owned);
+
+    // A resource not managing an address range can not tell.
+    EXPECT_EQ(m_upstream.owns(&on_stack), ownership::unknown);
+}
+
+/// Test allocating memory without exceptions
+TEST_F(core_contiguous_memory_resource_test, try_allocate) {
+
+    // A fixed size resource signals being full with a null pointer.
+    vecmem::contiguous_memory_resource fixed(m_upstream, 1024);
+    EXPECT_NE(fixed.try_allocate(1000), nullptr);
+    EXPECT_EQ(fixed.try_allocate(1000), nullptr);
+    void* p = nullptr;
+    EXPECT_THROW(p = fixed.allocate(1000), std::bad_alloc);
+
+    // A growable one just allocates a new chunk.
+    vecmem::contiguous_memory_resource growable(m_upstream, 1024, 2);
+    EXPECT_NE(growable.try_allocate(1000), nullptr);
+    EXPECT_NE(growable.try_allocate(1000), nullptr);
+
+    static_cast<void>(p);
+}
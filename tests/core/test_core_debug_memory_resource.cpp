@@ -8,6 +8,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
 #include "vecmem/memory/debug_memory_resource.hpp"
 #include "vecmem/memory/details/memory_resource_base.hpp"
 #include "vecmem/memory/host_memory_resource.hpp"
@@ -44,6 +48,31 @@ private:
     void* m_ptr = nullptr;
     std::size_t m_size;
 };
+
+class broken_overlapping_memory_resource final
+    : public vecmem::details::memory_resource_base {
+
+public:
+    broken_overlapping_memory_resource(memory_resource& upstream)
+        : m_upstream(upstream), m_ptr(upstream.allocate(4096)) {}
+
+    ~broken_overlapping_memory_resource() {
+        m_upstream.deallocate(m_ptr, 4096);
+    }
+
+private:
+    virtual void* do_allocate(std::size_t, std::size_t) override {
+        // Hand out pointers 256 bytes apart, regardless of the size.
+        return static_cast<char*>(m_ptr) + 256 * ((m_count++) % 4);
+    }
+
+    virtual void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    vecmem::memory_resource& m_upstream;
+
+    void* m_ptr;
+    std::size_t m_count = 0;
+};
 }  // namespace
 
 TEST(core_debug_memory_resource_test, double_allocate) {
@@ -90,3 +119,97 @@ TEST(core_debug_memory_resource_test, double_deallocate) {
     EXPECT_NO_THROW(res.deallocate(p, 1024));
     EXPECT_THROW(res.deallocate(p, 1024), std::logic_error);
 }
+
+TEST(core_debug_memory_resource_test, overlap_neighbours) {
+    vecmem::host_memory_resource ups;
+    broken_overlapping_memory_resource bro(ups);
+    vecmem::debug_memory_resource res(bro);
+
+    // Allocations overlapping with either the previous or the next
+    // outstanding allocation should be caught.
+    void* p1 = nullptr;
+    void* p2 = nullptr;
+    void* p3 = nullptr;
+    EXPECT_NO_THROW(p1 = res.allocate(256));
+    EXPECT_NO_THROW(p2 = res.allocate(512));
+    EXPECT_THROW(p3 = res.allocate(16), std::logic_error);
+    EXPECT_NO_THROW(p3 = res.allocate(16));
+    EXPECT_NO_THROW(res.deallocate(p1, 256));
+    EXPECT_THROW(p1 = res.allocate(1024), std::logic_error);
+    EXPECT_NO_THROW(res.deallocate(p2, 512));
+    EXPECT_NO_THROW(res.deallocate(p3, 16));
+}
+
+TEST(core_debug_memory_resource_test, sampling) {
+    vecmem::host_memory_resource ups;
+    vecmem::debug_memory_resource res(ups, 4);
+
+    // Every 4th allocation should be sampled.
+    std::vector<void*> ptrs;
+    std::vector<bool> sampled;
+    for (int i = 0; i < 128; ++i) {
+        ptrs.push_back(res.allocate(1024));
+        sampled.push_back(res.is_sampled(ptrs.back()));
+        EXPECT_EQ(sampled.back(), (i % 4 == 0));
+    }
+
+    // Mismatched de-allocations of sampled allocations should be caught,
+    // while the others should just be forwarded.
+    for (std::size_t i = 0; i < ptrs.size(); ++i) {
+        if (sampled[i]) {
+            EXPECT_THROW(res.deallocate(ptrs[i], 2048), std::logic_error);
+        }
+        EXPECT_NO_THROW(res.deallocate(ptrs[i], 1024));
+    }
+
+    // Double frees must be reported for all allocations.
+    for (void* p : ptrs) {
+        EXPECT_THROW(res.deallocate(p, 1024), std::logic_error);
+    }
+}
+
+TEST(core_debug_memory_resource_test, sampling_double_allocate) {
+    vecmem::host_memory_resource ups;
+    broken_double_allocate_memory_resource bro(ups);
+    vecmem::debug_memory_resource res(bro, 2);
+
+    // Handing out the same pointer twice is caught even when the second
+    // allocation is not sampled.
+    void* p = nullptr;
+    EXPECT_NO_THROW(p = res.allocate(1024));
+    EXPECT_TRUE(res.is_sampled(p));
+    EXPECT_THROW(p = res.allocate(1024), std::logic_error);
+}
+
+TEST(core_debug_memory_resource_test, sampling_overlap) {
+    vecmem::host_memory_resource ups;
+    broken_overlapping_memory_resource bro(ups);
+    vecmem::debug_memory_resource res(bro, 2);
+
+    // A sampled allocation overlapping with an unsampled one should be
+    // caught.
+    void* p1 = nullptr;
+    void* p2 = nullptr;
+    EXPECT_NO_THROW(p1 = res.allocate(256));
+    EXPECT_TRUE(res.is_sampled(p1));
+    EXPECT_NO_THROW(p2 = res.allocate(1024));
+    EXPECT_FALSE(res.is_sampled(p2));
+    void* p3 = nullptr;
+    EXPECT_THROW(p3 = res.allocate(16), std::logic_error);
+    EXPECT_EQ(p3, nullptr);
+    EXPECT_NO_THROW(res.deallocate(p1, 256));
+    EXPECT_NO_THROW(res.deallocate(p2, 1024));
+}
+
+TEST(core_debug_memory_resource_test, zero_size_allocations) {
+    vecmem::host_memory_resource ups;
+    broken_double_allocate_memory_resource bro(ups);
+    vecmem::debug_memory_resource res(bro);
+
+    // Zero sized allocations at the same address can not be told apart, so
+    // they must be reported instead of being dropped silently.
+    void* p = nullptr;
+    EXPECT_NO_THROW(p = res.allocate(0));
+    EXPECT_THROW(p = res.allocate(0), std::logic_error);
+    EXPECT_NO_THROW(res.deallocate(p, 0));
+}
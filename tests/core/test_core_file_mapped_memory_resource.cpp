@@ -0,0 +1,113 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif  // not _WIN32
+
+#include <cstddef>
+#include <cstdio>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "vecmem/containers/data/jagged_vector_buffer.hpp"
+#include "vecmem/containers/data/vector_buffer.hpp"
+#include "vecmem/containers/device_vector.hpp"
+#include "vecmem/containers/jagged_device_vector.hpp"
+#include "vecmem/memory/file_mapped_memory_resource.hpp"
+
+class core_file_mapped_memory_resource_test : public testing::Test {
+protected:
+    void SetUp() override {
+#ifdef _WIN32
+        GTEST_SKIP() << "File mapping is only available on POSIX systems";
+#else
+        // Use a separate file in every test (process), so that the tests
+        // could be run in parallel.
+        m_path = testing::TempDir() + "vecmem_file_mapped_" +
+                 testing::UnitTest::GetInstance()->current_test_info()->name() +
+                 "_" + std::to_string(getpid()) + ".bin";
+#endif  // _WIN32
+    }
+    void TearDown() override {
+        if (!m_path.empty()) {
+            std::remove(m_path.c_str());
+        }
+    }
+
+    std::string m_path;
+};
+
+TEST_F(core_file_mapped_memory_resource_test, allocations) {
+    vecmem::file_mapped_memory_resource res(
+        m_path, 100000,
+        vecmem::file_mapped_memory_resource::access_hint::sequential);
+    EXPECT_EQ(res.size(), 100000u);
+
+    // Allocations should be made one after the other in the file.
+    void* p1 = res.allocate(1000, 8);
+    void* p2 = res.allocate(1000, 256);
+    EXPECT_EQ(res.offset_of(p1), 0u);
+    EXPECT_EQ(res.offset_of(p2), 1024u);
+    res.prefetch(p2, 1000);
+
+    // Until the file is exhausted.
+    void* p3 = nullptr;
+    EXPECT_THROW(p3 = res.allocate(100000), std::bad_alloc);
+    EXPECT_EQ(p3, nullptr);
+    EXPECT_EQ(res.try_allocate(100000), nullptr);
+
+    // All memory should be reclaimed on request.
+    res.reset();
+    EXPECT_EQ(res.allocate(1000, 8), p1);
+}
+
+TEST_F(core_file_mapped_memory_resource_test, persistency) {
+    static const std::vector<std::size_t> sizes = {10, 0, 1000, 50};
+
+    // Write some data into buffers in the file.
+    {
+        vecmem::file_mapped_memory_resource res(m_path, 1000000);
+        vecmem::data::vector_buffer<int> buffer1(100, res);
+        vecmem::device_vector<int> vec1(buffer1);
+        for (unsigned int i = 0; i < vec1.size(); ++i) {
+            vec1[i] = static_cast<int>(i);
+        }
+        vecmem::data::jagged_vector_buffer<float> buffer2(sizes, res);
+        vecmem::jagged_device_vector<float> vec2(buffer2);
+        for (unsigned int i = 0; i < vec2.size(); ++i) {
+            for (unsigned int j = 0; j < vec2[i].size(); ++j) {
+                vec2[i][j] = static_cast<float>(i * j);
+            }
+        }
+        res.sync();
+    }
+
+    // Map the same file again, and set up the same buffers in it.
+    vecmem::file_mapped_memory_resource res(m_path, 0);
+    EXPECT_EQ(res.size(), 1000000u);
+    vecmem::data::vector_buffer<int> buffer1(100, res);
+    vecmem::device_vector<int> vec1(buffer1);
+    for (unsigned int i = 0; i < vec1.size(); ++i) {
+        EXPECT_EQ(vec1[i], static_cast<int>(i));
+    }
+    vecmem::data::jagged_vector_buffer<float> buffer2(sizes, res);
+    vecmem::jagged_device_vector<float> vec2(buffer2);
+    for (unsigned int i = 0; i < vec2.size(); ++i) {
+        for (unsigned int j = 0; j < vec2[i].size(); ++j) {
+            EXPECT_FLOAT_EQ(vec2[i][j], static_cast<float>(i * j));
+        }
+    }
+}
+
+TEST_F(core_file_mapped_memory_resource_test, failure) {
+    EXPECT_THROW(vecmem::file_mapped_memory_resource("/non/existent/file", 10),
+                 std::runtime_error);
+}
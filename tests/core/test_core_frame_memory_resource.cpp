@@ -0,0 +1,90 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "../common/monitored_upstream_test.hpp"
+#include "vecmem/memory/frame_memory_resource.hpp"
+
+/// Test case for @c vecmem::frame_memory_resource
+class core_frame_memory_resource_test : public monitored_upstream_test {};
+
+TEST_F(core_frame_memory_resource_test, rotation) {
+    vecmem::frame_memory_resource res(m_upstream, 4096);
+    EXPECT_EQ(res.n_frames(), 2);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 2 * 4096);
+
+    // Fill some memory in the first frame.
+    EXPECT_EQ(res.current_frame(), 0);
+    char* p1 = static_cast<char*>(res.allocate(1000));
+    std::memset(p1, 1, 1000);
+
+    // Memory of the previous frame must stay intact while the next frame is
+    // being used.
+    res.begin_frame();
+    EXPECT_EQ(res.current_frame(), 1);
+    char* p2 = static_cast<char*>(res.allocate(1000));
+    std::memset(p2, 2, 1000);
+    EXPECT_TRUE(std::all_of(p1, p1 + 1000, [](char c) { return c == 1; }));
+
+    // Once the first frame is retired, its memory should be re-used.
+    res.begin_frame();
+    EXPECT_EQ(res.current_frame(), 2);
+    EXPECT_EQ(res.allocate(1000), p1);
+    EXPECT_TRUE(std::all_of(p2, p2 + 1000, [](char c) { return c == 2; }));
+}
+
+TEST_F(core_frame_memory_resource_test, growth) {
+    vecmem::frame_memory_resource res(m_upstream, 4096, 3);
+    EXPECT_EQ(res.n_frames(), 3);
+
+    // A frame needing more memory than its arena has should grow the arena.
+    for (int i = 0; i < 10; ++i) {
+        void* p = res.allocate(1000);
+        EXPECT_NE(p, nullptr);
+    }
+    const std::size_t grown = m_monitor.outstanding_allocation();
+    EXPECT_GT(grown, 3 * 4096);
+
+    // Which should be kept once the frame is retired.
+    for (std::size_t i = 0; i < res.n_frames(); ++i) {
+        res.begin_frame();
+    }
+    EXPECT_EQ(m_monitor.outstanding_allocation(), grown);
+}
+
+TEST_F(core_frame_memory_resource_test, oversized_frames) {
+    vecmem::frame_memory_resource res(m_upstream, 4096);
+
+    // Let both arenas grow to the size of the (oversized) frames.
+    for (std::size_t frame = 0; frame < res.n_frames(); ++frame) {
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_NE(res.allocate(1000), nullptr);
+        }
+        res.begin_frame();
+    }
+    const std::size_t n_allocations =
+        m_upstream.get_statistics().m_n_allocations;
+    const std::size_t outstanding = m_monitor.outstanding_allocation();
+
+    // After which further frames of the same size must not make any
+    // upstream requests.
+    for (int frame = 0; frame < 10; ++frame) {
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_NE(res.allocate(1000), nullptr);
+        }
+        res.begin_frame();
+    }
+    EXPECT_EQ(m_upstream.get_statistics().m_n_allocations, n_allocations);
+    EXPECT_EQ(m_upstream.get_statistics().m_n_deallocations, 0);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), outstanding);
+}
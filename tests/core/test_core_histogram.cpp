@@ -0,0 +1,85 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+
+#include "vecmem/utils/histogram.hpp"
+
+TEST(core_histogram_test, buckets) {
+
+    // Every value must fall into the bucket that claims to hold it.
+    for (std::uint64_t value :
+         {std::uint64_t{0}, std::uint64_t{1}, std::uint64_t{15},
+          std::uint64_t{16}, std::uint64_t{17}, std::uint64_t{31},
+          std::uint64_t{32}, std::uint64_t{1000}, std::uint64_t{123456789},
+          std::numeric_limits<std::uint64_t>::max()}) {
+        const std::size_t i = vecmem::histogram::bucket_index(value);
+        ASSERT_LT(i, vecmem::histogram::n_buckets);
+        EXPECT_LE(vecmem::histogram::bucket_lower_bound(i), value);
+        EXPECT_GE(vecmem::histogram::bucket_upper_bound(i), value);
+    }
+
+    // The buckets must cover the full range without gaps.
+    for (std::size_t i = 1; i < vecmem::histogram::n_buckets; ++i) {
+        EXPECT_EQ(vecmem::histogram::bucket_lower_bound(i),
+                  vecmem::histogram::bucket_upper_bound(i - 1) + 1);
+    }
+    EXPECT_EQ(vecmem::histogram::bucket_upper_bound(
+                  vecmem::histogram::n_buckets - 1),
+              std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST(core_histogram_test, percentiles) {
+
+    vecmem::histogram h;
+    EXPECT_EQ(h.count(), 0);
+    EXPECT_EQ(h.percentile(50.), 0);
+
+    // Record the values 1..1000.
+    for (std::uint64_t i = 1; i <= 1000; ++i) {
+        h.record(i);
+    }
+    EXPECT_EQ(h.count(), 1000);
+    EXPECT_EQ(h.min(), 1);
+    EXPECT_EQ(h.max(), 1000);
+    EXPECT_DOUBLE_EQ(h.mean(), 500.5);
+
+    // The percentiles must be precise up to the bucket width.
+    EXPECT_EQ(h.percentile(0.), 1);
+    EXPECT_EQ(h.percentile(100.), 1000);
+    EXPECT_NEAR(static_cast<double>(h.percentile(50.)), 500., 500. / 16.);
+    EXPECT_NEAR(static_cast<double>(h.percentile(99.)), 990., 990. / 16.);
+    EXPECT_GE(h.percentile(99.), h.percentile(90.));
+}
+
+TEST(core_histogram_test, merge) {
+
+    vecmem::histogram h1, h2, all;
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        h1.record(i * 3);
+        all.record(i * 3);
+        h2.record(i * 1000, 2);
+        all.record(i * 1000, 2);
+    }
+
+    h1.merge(h2);
+    EXPECT_EQ(h1.count(), all.count());
+    EXPECT_EQ(h1.min(), all.min());
+    EXPECT_EQ(h1.max(), all.max());
+    EXPECT_DOUBLE_EQ(h1.mean(), all.mean());
+    for (std::size_t i = 0; i < vecmem::histogram::n_buckets; ++i) {
+        EXPECT_EQ(h1.bucket_count(i), all.bucket_count(i));
+    }
+
+    h1.reset();
+    EXPECT_EQ(h1.count(), 0);
+    EXPECT_EQ(h1.max(), 0);
+}
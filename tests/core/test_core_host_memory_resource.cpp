@@ -0,0 +1,64 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "vecmem/memory/host_memory_resource.hpp"
+
+class core_host_memory_resource_test : public testing::Test {
+protected:
+    vecmem::host_memory_resource m_default;
+    vecmem::host_memory_resource m_huge{1UL << 20};
+};
+
+TEST_F(core_host_memory_resource_test, alignment) {
+    for (vecmem::host_memory_resource* res : {&m_default, &m_huge}) {
+        for (std::size_t align = 1; align <= 65536; align *= 2) {
+            for (std::size_t size : {1UL, 100UL, 10000UL, 3000000UL}) {
+                void* p = res->allocate(size, align);
+                EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0u);
+                std::memset(p, 0, size);
+                res->deallocate(p, size, align);
+            }
+        }
+    }
+}
+
+TEST_F(core_host_memory_resource_test, huge_pages) {
+    EXPECT_EQ(m_default.huge_page_threshold(), 0);
+    EXPECT_EQ(m_huge.huge_page_threshold(), 1UL << 20);
+    EXPECT_TRUE(m_default.is_equal(m_huge));
+
+    // Large allocations should be aligned to the huge page size.
+    void* p = m_huge.allocate(3000000);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) %
+                  vecmem::host_memory_resource::huge_page_size,
+              0u);
+    std::memset(p, 0, 3000000);
+
+    // And can be de-allocated by any host memory resource.
+    m_default.deallocate(p, 3000000);
+}
+
+TEST_F(core_host_memory_resource_test, failure) {
+    void* p = nullptr;
+    EXPECT_THROW(p = m_default.allocate(static_cast<std::size_t>(-1) / 2),
+                 std::bad_alloc);
+    EXPECT_EQ(p, nullptr);
+
+    // Padding to the huge page size must not overflow.
+    const std::size_t huge_size = static_cast<std::size_t>(-1) - 1;
+    EXPECT_EQ(m_huge.try_allocate(huge_size), nullptr);
+    EXPECT_THROW(p = m_huge.allocate(huge_size), std::bad_alloc);
+    EXPECT_EQ(p, nullptr);
+}
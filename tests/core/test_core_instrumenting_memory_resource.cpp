@@ -9,7 +9,11 @@
 #include <gtest/gtest.h>
 
 #include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
+#include "vecmem/memory/debug_memory_resource.hpp"
 #include "vecmem/memory/host_memory_resource.hpp"
 #include "vecmem/memory/instrumenting_memory_resource.hpp"
 #include "vecmem/utils/memory_monitor.hpp"
@@ -137,6 +141,28 @@ TEST_F(core_instrumenting_memory_resource_test, pre_deallocate_hook) {
     EXPECT_EQ(total_size, 152);
 }
 
+TEST_F(core_instrumenting_memory_resource_test, throwing_upstream) {
+    vecmem::debug_memory_resource debug(m_upstream);
+    vecmem::instrumenting_memory_resource res(debug);
+
+    std::size_t n_pre = 0, n_post = 0;
+
+    res.add_pre_deallocate_hook(
+        [&n_pre](void*, std::size_t, std::size_t) { ++n_pre; });
+    res.add_post_deallocate_hook(
+        [&n_post](void*, std::size_t, std::size_t) { ++n_post; });
+
+    // The post-deallocation hooks must run even if the upstream resource
+    // rejects the request.
+    void* ptr = res.allocate(100);
+    res.deallocate(ptr, 100);
+    EXPECT_THROW(res.deallocate(ptr, 100), std::logic_error);
+
+    EXPECT_EQ(n_pre, 2);
+    EXPECT_EQ(n_post, 2);
+    EXPECT_EQ(res.get_events().size(), 3);
+}
+
 TEST_F(core_instrumenting_memory_resource_test, events) {
     vecmem::instrumenting_memory_resource res(m_upstream);
 
@@ -210,3 +236,165 @@ TEST_F(core_instrumenting_memory_resource_test, memory_monitor) {
     res.deallocate(ptr3, 100);
     EXPECT_EQ(monitor.outstanding_allocation(), 0);
 }
+
+TEST_F(core_instrumenting_memory_resource_test, ring_buffer) {
+    vecmem::instrumenting_memory_resource res(
+        m_upstream,
+        vecmem::instrumenting_memory_resource::recording::ring_buffer, 3);
+
+    // Perform more requests than what fits into the buffer.
+    std::vector<void*> ptrs;
+    for (std::size_t i = 1; i <= 4; ++i) {
+        ptrs.push_back(res.allocate(i * 10));
+    }
+    res.deallocate(ptrs[0], 10);
+
+    // Only the latest events should be kept, in chronological order.
+    const std::vector<vecmem::instrumenting_memory_resource::memory_event>
+        events = res.get_events();
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[0].m_size, 30);
+    EXPECT_EQ(events[1].m_size, 40);
+    EXPECT_EQ(events[2].m_type, vecmem::instrumenting_memory_resource::
+                                    memory_event::type::DEALLOCATION);
+    EXPECT_EQ(events[2].m_ptr, ptrs[0]);
+
+    // The statistics should know about all of the requests.
+    const vecmem::instrumenting_memory_resource::statistics stats =
+        res.get_statistics();
+    EXPECT_EQ(stats.m_n_allocations, 4);
+    EXPECT_EQ(stats.m_n_deallocations, 1);
+    EXPECT_EQ(stats.m_allocated_bytes, 100);
+    EXPECT_EQ(stats.m_deallocated_bytes, 10);
+
+    for (std::size_t i = 2; i <= 4; ++i) {
+        res.deallocate(ptrs[i - 1], i * 10);
+    }
+}
+
+TEST_F(core_instrumenting_memory_resource_test, aggregate) {
+    vecmem::instrumenting_memory_resource res(
+        m_upstream, vecmem::instrumenting_memory_resource::recording::aggregate,
+        0, vecmem::instrumenting_memory_resource::timing::ticks, 2);
+
+    void* ptr1 = res.allocate(100);
+    void* ptr2 = res.allocate(1000);
+    res.deallocate(ptr1, 100);
+    res.deallocate(ptr2, 1000);
+
+    // No events should be stored.
+    EXPECT_TRUE(res.get_events().empty());
+
+    // But the requests should show up in the statistics.
+    const vecmem::instrumenting_memory_resource::statistics stats =
+        res.get_statistics();
+    EXPECT_EQ(stats.m_n_allocations, 2);
+    EXPECT_EQ(stats.m_n_failed_allocations, 0);
+    EXPECT_EQ(stats.m_n_deallocations, 2);
+    EXPECT_EQ(stats.m_allocated_bytes, 1100);
+    EXPECT_EQ(stats.m_size_histogram.count(), 2);
+    EXPECT_EQ(stats.m_size_histogram.min(), 100);
+    EXPECT_EQ(stats.m_size_histogram.max(), 1000);
+
+    // Only every second request should have been timed.
+    EXPECT_EQ(stats.m_n_timed_allocations, 1);
+    EXPECT_EQ(stats.m_n_timed_deallocations, 1);
+    EXPECT_EQ(stats.m_allocation_time_histogram.count(), 1);
+    EXPECT_EQ(stats.m_deallocation_time_histogram.count(), 1);
+}
+
+TEST_F(core_instrumenting_memory_resource_test, memory_monitor_histograms) {
+
+    // Set up the memory resource, and the memory monitor
+    vecmem::instrumenting_memory_resource res(m_upstream);
+    vecmem::memory_monitor monitor(res);
+    vecmem::memory_monitor sampling_monitor(res, 10);
+
+    // Perform some allocations and de-allocations
+    std::vector<void*> ptrs;
+    for (std::size_t i = 1; i <= 100; ++i) {
+        ptrs.push_back(res.allocate(i * 10));
+    }
+    for (std::size_t i = 1; i <= 50; ++i) {
+        res.deallocate(ptrs[i - 1], i * 10);
+    }
+
+    // Check the histograms
+    const vecmem::histogram sizes = monitor.size_histogram();
+    EXPECT_EQ(sizes.count(), 100);
+    EXPECT_EQ(sizes.min(), 10);
+    EXPECT_EQ(sizes.max(), 1000);
+    EXPECT_NEAR(static_cast<double>(sizes.percentile(50.)), 500., 500. / 16.);
+    EXPECT_EQ(monitor.allocation_latency_histogram().count(), 100);
+    EXPECT_EQ(monitor.deallocation_latency_histogram().count(), 50);
+    EXPECT_EQ(monitor.lifetime_histogram().count(), 50);
+
+    // Histograms of several monitors can be merged.
+    vecmem::histogram merged = sizes;
+    merged.merge(monitor.size_histogram());
+    EXPECT_EQ(merged.count(), 200);
+
+    for (std::size_t i = 51; i <= 100; ++i) {
+        res.deallocate(ptrs[i - 1], i * 10);
+    }
+    EXPECT_EQ(monitor.lifetime_histogram().count(), 100);
+
+    // Lifetimes can also be sampled.
+    EXPECT_EQ(sampling_monitor.size_histogram().count(), 100);
+    EXPECT_EQ(sampling_monitor.lifetime_histogram().count(), 10);
+}
+
+TEST_F(core_instrumenting_memory_resource_test, concurrent) {
+
+    // Set up an instrumented resource, and monitor it
+    vecmem::instrumenting_memory_resource res(
+        m_upstream, vecmem::instrumenting_memory_resource::recording::aggregate,
+        0, vecmem::instrumenting_memory_resource::timing::ticks);
+    vecmem::memory_monitor monitor(res);
+
+    // Allocate memory on a number of threads, and free it on other ones.
+    static constexpr std::size_t n_threads = 8;
+    static constexpr std::size_t n_allocs = 1000;
+    std::vector<std::vector<void*>> ptrs(n_threads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&res, &ptrs, t]() {
+            for (std::size_t i = 0; i < n_allocs; ++i) {
+                ptrs[t].push_back(res.allocate(64));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    for (std::size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&res, &ptrs, t]() {
+            for (void* p : ptrs[(t + 1) % n_threads]) {
+                res.deallocate(p, 64);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Check that all of the requests were counted.
+    const vecmem::instrumenting_memory_resource::statistics stats =
+        res.get_statistics();
+    EXPECT_EQ(stats.m_n_allocations, n_threads * n_allocs);
+    EXPECT_EQ(stats.m_n_deallocations, n_threads * n_allocs);
+    EXPECT_EQ(stats.m_allocated_bytes, n_threads * n_allocs * 64);
+    EXPECT_EQ(stats.m_n_timed_allocations, n_threads * n_allocs);
+
+    EXPECT_EQ(monitor.total_allocation(), n_threads * n_allocs * 64);
+    EXPECT_EQ(monitor.outstanding_allocation(), 0);
+    EXPECT_EQ(monitor.average_allocation(), 64);
+    EXPECT_LE(monitor.maximal_allocation(), n_threads * n_allocs * 64);
+    EXPECT_EQ(monitor.size_histogram().count(), n_threads * n_allocs);
+    // Not all outstanding allocations fit into the lifetime sampling table.
+    EXPECT_GT(monitor.lifetime_histogram().count(), 0);
+    EXPECT_LE(monitor.lifetime_histogram().count(), n_threads * n_allocs);
+    EXPECT_EQ(monitor.deallocation_latency_histogram().count(),
+              n_threads * n_allocs);
+}
@@ -8,19 +8,25 @@
 // Local include(s).
 #include "../common/memory_resource_name_gen.hpp"
 #include "../common/memory_resource_test_basic.hpp"
+#include "../common/memory_resource_test_concurrent.hpp"
 #include "../common/memory_resource_test_host_accessible.hpp"
 #include "../common/memory_resource_test_stress.hpp"
 #include "vecmem/memory/arena_memory_resource.hpp"
 #include "vecmem/memory/binary_page_memory_resource.hpp"
+#include "vecmem/memory/caching_memory_resource.hpp"
 #include "vecmem/memory/choice_memory_resource.hpp"
 #include "vecmem/memory/coalescing_memory_resource.hpp"
 #include "vecmem/memory/conditional_memory_resource.hpp"
 #include "vecmem/memory/contiguous_memory_resource.hpp"
 #include "vecmem/memory/debug_memory_resource.hpp"
+#include "vecmem/memory/frame_memory_resource.hpp"
 #include "vecmem/memory/host_memory_resource.hpp"
 #include "vecmem/memory/identity_memory_resource.hpp"
 #include "vecmem/memory/instrumenting_memory_resource.hpp"
+#include "vecmem/memory/mmap_memory_resource.hpp"
+#include "vecmem/memory/numa_memory_resource.hpp"
 #include "vecmem/memory/terminal_memory_resource.hpp"
+#include "vecmem/memory/thread_caching_memory_resource.hpp"
 
 // GoogleTest include(s).
 #include <gtest/gtest.h>
@@ -30,11 +36,24 @@ static vecmem::terminal_memory_resource terminal_resource;
 
 // Memory resources to use in the test.
 static vecmem::host_memory_resource host_resource;
+static vecmem::host_memory_resource huge_page_host_resource(1UL << 20);
+static vecmem::mmap_memory_resource mmap_resource;
+static vecmem::numa_memory_resource numa_resource;
 static vecmem::binary_page_memory_resource binary_resource(host_resource);
+static vecmem::binary_page_memory_resource sharded_binary_resource(
+    host_resource, 4);
 static vecmem::contiguous_memory_resource contiguous_resource(host_resource,
                                                               20000);
+static vecmem::frame_memory_resource frame_resource(host_resource, 20000);
 static vecmem::arena_memory_resource arena_resource(host_resource, 20000,
                                                     10000000);
+static vecmem::arena_memory_resource multi_arena_resource(host_resource, 20000,
+                                                          10000000, 4);
+static vecmem::binary_page_memory_resource thread_caching_upstream(
+    host_resource);
+static vecmem::thread_caching_memory_resource thread_caching_resource(
+    thread_caching_upstream);
+static vecmem::caching_memory_resource caching_resource(host_resource, 100000);
 static vecmem::instrumenting_memory_resource instrumenting_resource(
     host_resource);
 static vecmem::identity_memory_resource identity_resource(host_resource);
@@ -56,17 +75,25 @@ static vecmem::debug_memory_resource debug_arena_resource(arena_resource);
 // Instantiate the test suite(s).
 INSTANTIATE_TEST_SUITE_P(
     core_memory_resource_tests, memory_resource_test_basic,
-    testing::Values(&host_resource, &binary_resource, &arena_resource,
+    testing::Values(&host_resource, &huge_page_host_resource, &mmap_resource,
+                    &numa_resource, &binary_resource, &sharded_binary_resource,
+                    &arena_resource, &multi_arena_resource,
                     &instrumenting_resource, &identity_resource,
                     &conditional_resource, &coalescing_resource_1,
                     &coalescing_resource_2, &choice_resource,
                     &debug_host_resource, &debug_binary_resource,
-                    &debug_arena_resource),
+                    &debug_arena_resource, &thread_caching_resource,
+                    &caching_resource, &frame_resource),
     vecmem::testing::memory_resource_name_gen(
         {{&host_resource, "host_resource"},
+         {&huge_page_host_resource, "huge_page_host_resource"},
+         {&mmap_resource, "mmap_resource"},
+         {&numa_resource, "numa_resource"},
          {&binary_resource, "binary_resource"},
+         {&sharded_binary_resource, "sharded_binary_resource"},
          {&contiguous_resource, "contiguous_resource"},
          {&arena_resource, "arena_resource"},
+         {&multi_arena_resource, "multi_arena_resource"},
          {&instrumenting_resource, "instrumenting_resource"},
          {&identity_resource, "identity_resource"},
          {&conditional_resource, "conditional_resource"},
@@ -75,22 +102,33 @@ INSTANTIATE_TEST_SUITE_P(
          {&choice_resource, "choice_resource"},
          {&debug_host_resource, "debug_host_resource"},
          {&debug_binary_resource, "debug_binary_resource"},
-         {&debug_arena_resource, "debug_arena_resource"}}));
+         {&debug_arena_resource, "debug_arena_resource"},
+         {&thread_caching_resource, "thread_caching_resource"},
+         {&caching_resource, "caching_resource"},
+         {&frame_resource, "frame_resource"}}));
 
 // Instantiate the test suite(s).
 INSTANTIATE_TEST_SUITE_P(
     core_memory_resource_tests, memory_resource_test_host_accessible,
-    testing::Values(&host_resource, &binary_resource, &arena_resource,
+    testing::Values(&host_resource, &huge_page_host_resource, &mmap_resource,
+                    &numa_resource, &binary_resource, &sharded_binary_resource,
+                    &arena_resource, &multi_arena_resource,
                     &instrumenting_resource, &identity_resource,
                     &conditional_resource, &coalescing_resource_1,
                     &coalescing_resource_2, &choice_resource,
                     &debug_host_resource, &debug_binary_resource,
-                    &debug_arena_resource),
+                    &debug_arena_resource, &thread_caching_resource,
+                    &caching_resource, &frame_resource),
     vecmem::testing::memory_resource_name_gen(
         {{&host_resource, "host_resource"},
+         {&huge_page_host_resource, "huge_page_host_resource"},
+         {&mmap_resource, "mmap_resource"},
+         {&numa_resource, "numa_resource"},
          {&binary_resource, "binary_resource"},
+         {&sharded_binary_resource, "sharded_binary_resource"},
          {&contiguous_resource, "contiguous_resource"},
          {&arena_resource, "arena_resource"},
+         {&multi_arena_resource, "multi_arena_resource"},
          {&instrumenting_resource, "instrumenting_resource"},
          {&identity_resource, "identity_resource"},
          {&conditional_resource, "conditional_resource"},
@@ -99,20 +137,31 @@ INSTANTIATE_TEST_SUITE_P(
          {&choice_resource, "choice_resource"},
          {&debug_host_resource, "debug_host_resource"},
          {&debug_binary_resource, "debug_binary_resource"},
-         {&debug_arena_resource, "debug_arena_resource"}}));
+         {&debug_arena_resource, "debug_arena_resource"},
+         {&thread_caching_resource, "thread_caching_resource"},
+         {&caching_resource, "caching_resource"},
+         {&frame_resource, "frame_resource"}}));
 
 INSTANTIATE_TEST_SUITE_P(
     core_memory_resource_stress_tests, memory_resource_test_stress,
-    testing::Values(&host_resource, &binary_resource, &arena_resource,
+    testing::Values(&host_resource, &huge_page_host_resource, &mmap_resource,
+                    &numa_resource, &binary_resource, &sharded_binary_resource,
+                    &arena_resource, &multi_arena_resource,
                     &instrumenting_resource, &identity_resource,
                     &conditional_resource, &coalescing_resource_1,
                     &coalescing_resource_2, &choice_resource,
                     &debug_host_resource, &debug_binary_resource,
-                    &debug_arena_resource),
+                    &debug_arena_resource, &thread_caching_resource,
+                    &caching_resource),
     vecmem::testing::memory_resource_name_gen(
         {{&host_resource, "host_resource"},
+         {&huge_page_host_resource, "huge_page_host_resource"},
+         {&mmap_resource, "mmap_resource"},
+         {&numa_resource, "numa_resource"},
          {&binary_resource, "binary_resource"},
+         {&sharded_binary_resource, "sharded_binary_resource"},
          {&arena_resource, "arena_resource"},
+         {&multi_arena_resource, "multi_arena_resource"},
          {&instrumenting_resource, "instrumenting_resource"},
          {&identity_resource, "identity_resource"},
          {&conditional_resource, "conditional_resource"},
@@ -121,4 +170,17 @@ INSTANTIATE_TEST_SUITE_P(
          {&choice_resource, "choice_resource"},
          {&debug_host_resource, "debug_host_resource"},
          {&debug_binary_resource, "debug_binary_resource"},
-         {&debug_arena_resource, "debug_arena_resource"}}));
+         {&debug_arena_resource, "debug_arena_resource"},
+         {&thread_caching_resource, "thread_caching_resource"},
+         {&caching_resource, "caching_resource"}}));
+
+INSTANTIATE_TEST_SUITE_P(
+    core_memory_resource_concurrent_tests, memory_resource_test_concurrent,
+    testing::Values(&host_resource, &mmap_resource, &sharded_binary_resource,
+                    &multi_arena_resource, &thread_caching_resource),
+    vecmem::testing::memory_resource_name_gen(
+        {{&host_resource, "host_resource"},
+         {&mmap_resource, "mmap_resource"},
+         {&sharded_binary_resource, "sharded_binary_resource"},
+         {&multi_arena_resource, "multi_arena_resource"},
+         {&thread_caching_resource, "thread_caching_resource"}}));
@@ -0,0 +1,74 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "vecmem/memory/arena_memory_resource.hpp"
+#include "vecmem/memory/binary_page_memory_resource.hpp"
+#include "vecmem/memory/mmap_memory_resource.hpp"
+
+TEST(core_mmap_memory_resource_test, alignment) {
+    for (auto pages : {vecmem::mmap_memory_resource::huge_pages::none,
+                       vecmem::mmap_memory_resource::huge_pages::transparent,
+                       vecmem::mmap_memory_resource::huge_pages::hugetlb}) {
+        vecmem::mmap_memory_resource res(true, pages);
+        for (std::size_t align = 1; align <= 65536; align *= 4) {
+            for (std::size_t size : {1UL, 10000UL, 3000000UL}) {
+                void* p = res.allocate(size, align);
+                EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0u);
+                std::memset(p, 1, size);
+                res.deallocate(p, size, align);
+            }
+        }
+        EXPECT_EQ(res.retained_bytes(), 0u);
+    }
+}
+
+TEST(core_mmap_memory_resource_test, retained_mappings) {
+    vecmem::mmap_memory_resource res(
+        false, vecmem::mmap_memory_resource::huge_pages::none, false);
+
+    // Freed mappings should be kept, and re-used for the same sizes.
+    void* p1 = res.allocate(100000);
+    void* p2 = res.allocate(200000);
+    res.deallocate(p1, 100000);
+    EXPECT_GE(res.retained_bytes(), 100000u);
+    EXPECT_EQ(res.allocate(100000), p1);
+    EXPECT_EQ(res.retained_bytes(), 0u);
+
+    // Until they are released explicitly.
+    res.deallocate(p1, 100000);
+    res.deallocate(p2, 200000);
+    const std::size_t retained = res.retained_bytes();
+    EXPECT_GE(retained, 300000u);
+    EXPECT_EQ(res.release_unused(), retained);
+    EXPECT_EQ(res.retained_bytes(), 0u);
+}
+
+TEST(core_mmap_memory_resource_test, upstream) {
+    vecmem::mmap_memory_resource ups(
+        true, vecmem::mmap_memory_resource::huge_pages::transparent);
+
+    // The memory resource should work as the upstream of pools.
+    vecmem::binary_page_memory_resource binary(ups);
+    vecmem::arena_memory_resource arena(ups, 1UL << 20, 1UL << 30);
+    for (vecmem::memory_resource* res :
+         {static_cast<vecmem::memory_resource*>(&binary),
+          static_cast<vecmem::memory_resource*>(&arena)}) {
+        void* p1 = res->allocate(1000);
+        void* p2 = res->allocate(5000000);
+        std::memset(p1, 2, 1000);
+        std::memset(p2, 3, 5000000);
+        res->deallocate(p1, 1000);
+        res->deallocate(p2, 5000000);
+    }
+}
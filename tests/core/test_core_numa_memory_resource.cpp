@@ -0,0 +1,55 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+
+#include "vecmem/memory/numa_memory_resource.hpp"
+
+TEST(core_numa_memory_resource_test, nodes) {
+    EXPECT_GE(vecmem::numa_memory_resource::n_nodes(), 1u);
+    if (vecmem::numa_memory_resource::n_nodes() == 1) {
+        EXPECT_EQ(vecmem::numa_memory_resource::current_node(), 0u);
+    }
+}
+
+TEST(core_numa_memory_resource_test, policies) {
+    for (auto pol : {vecmem::numa_memory_resource::policy::bind,
+                     vecmem::numa_memory_resource::policy::interleave,
+                     vecmem::numa_memory_resource::policy::local}) {
+        vecmem::numa_memory_resource res(pol, 0, true);
+        EXPECT_EQ(res.get_policy(), pol);
+        void* p = res.allocate(1000000, 64);
+        std::memset(p, 1, 1000000);
+        res.deallocate(p, 1000000, 64);
+    }
+}
+
+TEST(core_numa_memory_resource_test, bind) {
+    // Memory bound to the first node must be found on that node. (If the
+    // node of the memory can be queried at all.)
+    vecmem::numa_memory_resource res(vecmem::numa_memory_resource::policy::bind,
+                                     0);
+    void* p = res.allocate(100000);
+    std::memset(p, 1, 100000);
+    const int node = vecmem::numa_memory_resource::node_of(p);
+    if (node >= 0) {
+        EXPECT_EQ(node, 0);
+    }
+    res.deallocate(p, 100000);
+
+    // Binding to a node that does not exist should not be an error.
+    vecmem::numa_memory_resource res2(
+        vecmem::numa_memory_resource::policy::bind,
+        vecmem::numa_memory_resource::n_nodes() + 10);
+    p = res2.allocate(100000);
+    std::memset(p, 1, 100000);
+    res2.deallocate(p, 100000);
+}
@@ -0,0 +1,193 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+// The memory resource is only available on POSIX systems.
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vecmem/containers/data/jagged_vector_buffer.hpp"
+#include "vecmem/containers/data/vector_buffer.hpp"
+#include "vecmem/containers/device_vector.hpp"
+#include "vecmem/containers/jagged_device_vector.hpp"
+#include "vecmem/memory/host_memory_resource.hpp"
+#include "vecmem/memory/shared_memory_resource.hpp"
+
+class core_shared_memory_resource_test : public testing::Test {
+protected:
+    /// Fill a resizable 1D and a jagged buffer in a shared memory segment
+    void fill(vecmem::shared_memory_resource& res,
+              vecmem::shared_memory_resource::vector_descriptor& desc1,
+              vecmem::shared_memory_resource::jagged_vector_descriptor& desc2) {
+        vecmem::data::vector_buffer<int> buffer1(100, 0, res);
+        vecmem::device_vector<int> vec1(buffer1);
+        for (int i = 0; i < 50; ++i) {
+            vec1.push_back(i);
+        }
+        vecmem::data::jagged_vector_buffer<float> buffer2(m_sizes, res);
+        vecmem::jagged_device_vector<float> vec2(buffer2);
+        for (unsigned int i = 0; i < vec2.size(); ++i) {
+            for (unsigned int j = 0; j < vec2[i].size(); ++j) {
+                vec2[i][j] = static_cast<float>(i * j);
+            }
+        }
+        desc1 = res.export_view(vecmem::get_data(buffer1));
+        desc2 = res.export_view(vecmem::get_data(buffer2));
+    }
+
+    /// Check the contents of the buffers exported by @c fill(...)
+    bool check(
+        const vecmem::shared_memory_resource& res,
+        const vecmem::shared_memory_resource::vector_descriptor& desc1,
+        const vecmem::shared_memory_resource::jagged_vector_descriptor& desc2) {
+        vecmem::device_vector<const int> vec1(res.import_vector<int>(desc1));
+        bool result = (vec1.size() == 50);
+        for (unsigned int i = 0; i < vec1.size(); ++i) {
+            result &= (vec1[i] == static_cast<int>(i));
+        }
+        auto data2 = res.import_jagged_vector<float>(desc2, m_host);
+        vecmem::jagged_device_vector<const float> vec2(data2);
+        result &= (vec2.size() == m_sizes.size());
+        for (unsigned int i = 0; i < vec2.size(); ++i) {
+            result &= (vec2[i].size() == m_sizes[i]);
+            for (unsigned int j = 0; j < vec2[i].size(); ++j) {
+                result &= (vec2[i][j] == static_cast<float>(i * j));
+            }
+        }
+        return result;
+    }
+
+    vecmem::host_memory_resource m_host;
+    std::vector<std::size_t> m_sizes = {10, 0, 1000, 50};
+    std::string m_name = "/vecmem_test_" + std::to_string(getpid());
+};
+
+TEST_F(core_shared_memory_resource_test, allocations) {
+    vecmem::shared_memory_resource res(100000);
+    EXPECT_GE(res.fd(), 0);
+    EXPECT_EQ(res.size(), 100000u);
+
+    void* p1 = res.allocate(1000, 8);
+    void* p2 = res.allocate(1000, 256);
+    EXPECT_EQ(res.at_offset(res.offset_of(p1)), p1);
+    EXPECT_EQ(res.offset_of(p2) % 256, 0u);
+    void* p3 = nullptr;
+    EXPECT_THROW(p3 = res.allocate(100000), std::bad_alloc);
+    EXPECT_EQ(p3, nullptr);
+    EXPECT_EQ(res.try_allocate(100000), nullptr);
+    res.reset();
+    EXPECT_EQ(res.allocate(1000, 8), p1);
+}
+
+TEST_F(core_shared_memory_resource_test, export_import) {
+    // Map the same segment twice, at different addresses.
+    vecmem::shared_memory_resource producer(m_name, 1000000);
+    vecmem::shared_memory_resource consumer(m_name, 0);
+    EXPECT_EQ(consumer.size(), producer.size());
+    EXPECT_NE(consumer.at_offset(0), producer.at_offset(0));
+
+    // Buffers filled through one mapping should be visible through the other.
+    vecmem::shared_memory_resource::vector_descriptor desc1;
+    vecmem::shared_memory_resource::jagged_vector_descriptor desc2;
+    fill(producer, desc1, desc2);
+    EXPECT_TRUE(check(consumer, desc1, desc2));
+
+    // And both should be allocating from the same memory.
+    void* p1 = producer.allocate(100);
+    void* p2 = consumer.allocate(100);
+    EXPECT_NE(producer.offset_of(p1), consumer.offset_of(p2));
+}
+
+TEST_F(core_shared_memory_resource_test, inter_process) {
+    vecmem::shared_memory_resource producer(m_name, 1000000);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Receive the descriptors, and check the data in a new mapping.
+        close(fds[1]);
+        vecmem::shared_memory_resource::vector_descriptor desc1;
+        vecmem::shared_memory_resource::jagged_vector_descriptor desc2;
+        bool ok = (read(fds[0], &desc1, sizeof(desc1)) == sizeof(desc1)) &&
+                  (read(fds[0], &desc2, sizeof(desc2)) == sizeof(desc2));
+        vecmem::shared_memory_resource consumer(m_name, 0);
+        ok = ok && check(consumer, desc1, desc2);
+        _exit(ok ? 0 : 1);
+    }
+
+    // Fill the buffers, and send their descriptors to the child process.
+    close(fds[0]);
+    vecmem::shared_memory_resource::vector_descriptor desc1;
+    vecmem::shared_memory_resource::jagged_vector_descriptor desc2;
+    fill(producer, desc1, desc2);
+    EXPECT_EQ(write(fds[1], &desc1, sizeof(desc1)), sizeof(desc1));
+    EXPECT_EQ(write(fds[1], &desc2, sizeof(desc2)), sizeof(desc2));
+    close(fds[1]);
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST_F(core_shared_memory_resource_test, inter_process_fd) {
+    vecmem::shared_memory_resource producer(1000000);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Receive the descriptors, and map the inherited anonymous segment.
+        close(fds[1]);
+        int fd = -1;
+        vecmem::shared_memory_resource::vector_descriptor desc1;
+        vecmem::shared_memory_resource::jagged_vector_descriptor desc2;
+        bool ok = (read(fds[0], &fd, sizeof(fd)) == sizeof(fd)) &&
+                  (read(fds[0], &desc1, sizeof(desc1)) == sizeof(desc1)) &&
+                  (read(fds[0], &desc2, sizeof(desc2)) == sizeof(desc2));
+        vecmem::shared_memory_resource consumer(
+            vecmem::shared_memory_resource::from_fd, fd);
+        ok = ok && (consumer.size() == 1000000u);
+        ok = ok && check(consumer, desc1, desc2);
+        _exit(ok ? 0 : 1);
+    }
+
+    // Fill the buffers, and send the segment's descriptor and the buffer
+    // descriptors to the child process.
+    close(fds[0]);
+    vecmem::shared_memory_resource::vector_descriptor desc1;
+    vecmem::shared_memory_resource::jagged_vector_descriptor desc2;
+    fill(producer, desc1, desc2);
+    const int fd = producer.fd();
+    EXPECT_EQ(write(fds[1], &fd, sizeof(fd)), sizeof(fd));
+    EXPECT_EQ(write(fds[1], &desc1, sizeof(desc1)), sizeof(desc1));
+    EXPECT_EQ(write(fds[1], &desc2, sizeof(desc2)), sizeof(desc2));
+    close(fds[1]);
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    // Invalid descriptors are reported.
+    EXPECT_THROW(vecmem::shared_memory_resource(
+                     vecmem::shared_memory_resource::from_fd, -1),
+                 std::runtime_error);
+}
+#endif  // not _WIN32
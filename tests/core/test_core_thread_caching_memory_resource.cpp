@@ -0,0 +1,118 @@
+/*
+ * VecMem project, part of the ACTS project (R&D line)
+ *
+ * (c) 2022 CERN for the benefit of the ACTS project
+ *
+ * Mozilla Public License Version 2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "../common/monitored_upstream_test.hpp"
+#include "vecmem/memory/thread_caching_memory_resource.hpp"
+
+/// Test case for @c vecmem::thread_caching_memory_resource
+class core_thread_caching_memory_resource_test
+    : public monitored_upstream_test {};
+
+TEST_F(core_thread_caching_memory_resource_test, reuse) {
+    vecmem::thread_caching_memory_resource res(m_upstream);
+
+    // The first allocation has to go upstream, rounded up to its size class.
+    void* p1 = res.allocate(100);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 128);
+    EXPECT_EQ(res.cache_hits(), 0);
+    EXPECT_EQ(res.cache_misses(), 1);
+
+    // After freeing it, an allocation of the same size class must get the
+    // same block back, without going upstream.
+    res.deallocate(p1, 100);
+    void* p2 = res.allocate(120);
+    EXPECT_EQ(p1, p2);
+    EXPECT_EQ(m_monitor.total_allocation(), 128);
+    EXPECT_EQ(res.cache_hits(), 1);
+    EXPECT_EQ(res.cache_misses(), 1);
+    EXPECT_DOUBLE_EQ(res.hit_rate(), 0.5);
+
+    // Large allocations are not cached at all.
+    void* p3 = res.allocate(100000);
+    res.deallocate(p3, 100000);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 128);
+    EXPECT_EQ(res.cache_misses(), 1);
+
+    // Flushing the cache gives the freed blocks back to upstream.
+    res.deallocate(p2, 120);
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 128);
+    res.flush();
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 0);
+}
+
+TEST_F(core_thread_caching_memory_resource_test, bounded_cache) {
+    vecmem::thread_caching_memory_resource res(m_upstream, 8);
+
+    // Allocate, and then free, more blocks than what the cache may hold.
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < 20; ++i) {
+        ptrs.push_back(res.allocate(64));
+    }
+    for (void* p : ptrs) {
+        res.deallocate(p, 64);
+    }
+
+    // No more than the maximal number of blocks may be kept in the cache.
+    EXPECT_LE(m_monitor.outstanding_allocation(), 8 * 64);
+    EXPECT_GT(m_monitor.outstanding_allocation(), 0);
+}
+
+TEST_F(core_thread_caching_memory_resource_test, thread_exit) {
+    vecmem::thread_caching_memory_resource res(m_upstream);
+
+    // Let other threads allocate and free memory, leaving it in their
+    // caches.
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&res]() {
+            for (std::size_t i = 0; i < 100; ++i) {
+                void* p = res.allocate(1000);
+                res.deallocate(p, 1000);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // The caches of the threads must have been flushed when they exited,
+    // and their statistics must have been kept.
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 0);
+    EXPECT_EQ(res.cache_misses(), 4);
+    EXPECT_EQ(res.cache_hits(), 4 * 99);
+}
+
+TEST_F(core_thread_caching_memory_resource_test, resource_destruction) {
+
+    // Destroy the memory resource while a thread still has blocks in its
+    // cache.
+    std::vector<void*> ptrs;
+    {
+        vecmem::thread_caching_memory_resource res(m_upstream);
+        for (std::size_t i = 0; i < 10; ++i) {
+            ptrs.push_back(res.allocate(256));
+        }
+        for (void* p : ptrs) {
+            res.deallocate(p, 256);
+        }
+        EXPECT_EQ(m_monitor.outstanding_allocation(), 10 * 256);
+    }
+    EXPECT_EQ(m_monitor.outstanding_allocation(), 0);
+
+    // A new memory resource must not pick up the cache of the old one.
+    vecmem::thread_caching_memory_resource res(m_upstream);
+    void* p = res.allocate(256);
+    EXPECT_EQ(res.cache_misses(), 1);
+    res.deallocate(p, 256);
+}